@@ -0,0 +1,592 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../src/allocator.h"
+#include "../src/allocsim.h"
+
+// benchmark harness -> generates a synthetic RQ/RL/C workload once, then replays it on every strategy through liballocsim.a
+// and reports throughput, per command latency percentiles and nodes visited per allocation
+// with -u it drives a running --serve daemon instead, one connection per client thread
+// with -K it times the block table search kernels on synthetic maps of the given sizes
+
+
+// ************************************** WORKLOAD *************************************
+
+typedef struct {
+    char command;  // 'q' for RQ, 'l' for RL, 'z' for RS, 'c' for C
+    char PID[12];  // process id name for RQ, RL and RS
+    long size;     // bytes for RQ and RS
+    bool longLived; // RQ of a long-lived process, see drawLifetime -> sent with a LONG hint when hints are on
+} Operation;
+
+typedef struct {
+    int operations;    // number of operations to generate
+    long memory;       // total memory given to the allocator
+    char *sizeDist;    // uniform, power, bimodal or classes
+    long minSize;      // smallest request
+    long maxSize;      // biggest request
+    char *lifeDist;    // exp, uniform, fixed or bimodal
+    int meanLife;      // mean lifetime of a process counted in operations
+    int compactEvery;  // emit C after this many operations -> 0 never
+    int resizePercent; // share of the other operations that resize a live process instead of requesting a new one
+    unsigned long long seed;
+    char *strategies;  // strategy flags to replay, e.g. "FBWYT"
+    char *socketPath;  // daemon to load test -> NULL replays in process
+    char *clientCounts; // comma separated client thread counts for the load test
+    char *table;       // off, on or both -> replay with the structure of arrays block table
+    char *quick;       // off, on or both -> replay with quick lists and deferred merging
+    char *hints;       // off, on or both -> replay with SHORT/LONG lifetime hints on RQ
+    char *kernelBlocks; // comma separated map sizes for the kernel microbenchmark -> NULL replays
+} Config;
+
+unsigned long long rngState;
+
+// xorshift64* random number generator -> same seed gives the same workload
+unsigned long long nextRandom(){
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 2685821657736338717ULL;
+}
+
+// uniform double in (0, 1]
+double nextUniform(){ return ((nextRandom() >> 11) + 1) * (1.0 / 9007199254740992.0); }
+
+long uniformLong(long low, long high){ return low + (long) (nextRandom() % (unsigned long long) (high - low + 1)); }
+
+long drawSize(Config *config){
+    if (strcmp(config->sizeDist, "power") == 0) {
+        // pareto with alpha 1.5 -> many small requests and a long tail of big ones
+        double size = config->minSize / pow(nextUniform(), 1 / 1.5);
+        return size > config->maxSize ? config->maxSize : (long) size;
+    }
+    if (strcmp(config->sizeDist, "classes") == 0) {
+        // 8 sizes spread geometrically between min and max -> the same sizes come back again and again
+        double step = pow((double) config->maxSize / config->minSize, 1 / 7.0);
+        return (long) (config->minSize * pow(step, (double) (nextRandom() % 8)));
+    }
+    if (strcmp(config->sizeDist, "bimodal") == 0) {
+        // 90% small requests, 10% big requests
+        long smallMax = config->minSize * 8 < config->maxSize ? config->minSize * 8 : config->maxSize;
+        if (nextRandom() % 10 != 0) return uniformLong(config->minSize, smallMax);
+        return uniformLong(config->maxSize / 8 > config->minSize ? config->maxSize / 8 : config->minSize, config->maxSize);
+    }
+    return uniformLong(config->minSize, config->maxSize);
+}
+
+// longLived gets the lifetime class -> longer than the mean, or the long class of bimodal
+int drawLifetime(Config *config, bool *longLived){
+    int lifetime;
+    if (strcmp(config->lifeDist, "fixed") == 0) lifetime = config->meanLife;
+    else if (strcmp(config->lifeDist, "uniform") == 0) lifetime = uniformLong(1, 2 * config->meanLife);
+    else if (strcmp(config->lifeDist, "bimodal") == 0) {
+        // 80% live a quarter of the mean, 20% four times the mean -> exponential inside each class, same overall mean
+        *longLived = nextRandom() % 5 == 0;
+        return 1 + (int) (-log(nextUniform()) * (*longLived ? 4.0 : 0.25) * config->meanLife);
+    }
+    else lifetime = 1 + (int) (-log(nextUniform()) * config->meanLife); // exponential with the given mean
+
+    *longLived = lifetime > config->meanLife;
+    return lifetime;
+}
+
+// min heap of live processes ordered by the operation index they die at
+typedef struct {
+    long death;
+    int id;
+} Death;
+
+Death *heap;
+int heapSize;
+
+void heapPush(Death d){
+    int i = heapSize++;
+    while (i > 0 && heap[(i - 1) / 2].death > d.death) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = d;
+}
+
+Death heapPop(){
+    Death top = heap[0];
+    Death last = heap[--heapSize];
+    int i = 0;
+    while (2 * i + 1 < heapSize) {
+        int child = 2 * i + 1;
+        if (child + 1 < heapSize && heap[child + 1].death < heap[child].death) child++;
+        if (heap[child].death >= last.death) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+// builds the operation list -> processes are released when their lifetime runs out
+Operation *generateWorkload(Config *config){
+    Operation *ops = (Operation *) malloc(sizeof(Operation) * config->operations);
+    heap = (Death *) malloc(sizeof(Death) * config->operations);
+    heapSize = 0;
+    rngState = config->seed;
+
+    int count = 0;
+    int nextId = 0;
+    for (long step = 0; count < config->operations; step++) {
+        if (heapSize > 0 && heap[0].death <= step) { // oldest due process is released first
+            Death d = heapPop();
+            ops[count].command = 'l';
+            sprintf(ops[count].PID, "P%d", d.id);
+        }
+        else if (config->compactEvery > 0 && step % config->compactEvery == config->compactEvery - 1) {
+            ops[count].command = 'c';
+        }
+        else if (heapSize > 0 && (int) (nextRandom() % 100) < config->resizePercent) { // new size for a live process
+            ops[count].command = 'z';
+            sprintf(ops[count].PID, "P%d", heap[nextRandom() % heapSize].id);
+            ops[count].size = drawSize(config);
+        }
+        else {
+            Death d = { step + drawLifetime(config, &ops[count].longLived), nextId++ };
+            ops[count].command = 'q';
+            sprintf(ops[count].PID, "P%d", d.id);
+            ops[count].size = drawSize(config);
+            heapPush(d);
+        }
+        count++;
+    }
+
+    free(heap);
+    return ops;
+}
+
+// *************************************************************************************
+
+
+
+// *************************************** REPLAY **************************************
+
+typedef struct {
+    long *latencies; // nanoseconds of every call of this command
+    int count;
+} Samples;
+
+long nowNanoseconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+int compareLong(const void *a, const void *b){
+    long x = *(const long *) a, y = *(const long *) b;
+    return (x > y) - (x < y);
+}
+
+long percentile(Samples *samples, double p){
+    if (samples->count == 0) return 0;
+    int i = (int) (p * (samples->count - 1));
+    return samples->latencies[i];
+}
+
+void printSamples(Samples *samples){
+    qsort(samples->latencies, samples->count, sizeof(long), compareLong);
+    printf(" %8ld %8ld %8ld", percentile(samples, 0.50), percentile(samples, 0.99), percentile(samples, 0.999));
+}
+
+#define FAILED_MARK_PERCENT 1 // rows where more requests failed are marked -> failures return early, so their timings look too good
+
+// replays the workload with every RQ using the given strategy flag -> true if the row was marked for failed requests
+bool replay(Config *config, Operation *ops, char strategy, bool table, bool quick, bool hints){
+    Samples rq = { malloc(sizeof(long) * config->operations), 0 };
+    Samples rl = { malloc(sizeof(long) * config->operations), 0 };
+    Samples c = { malloc(sizeof(long) * config->operations), 0 };
+    Samples rs = { malloc(sizeof(long) * config->operations), 0 };
+    int failed = 0;
+    int requests = 0; // RQs and RSs that could fail for lack of memory
+    long visited = 0;
+
+    AllocSim *sim = allocsim_create(config->memory); // failed requests are counted, not printed
+    allocsim_set_block_table(sim, table);
+    allocsim_set_quick_lists(sim, quick);
+    long start = nowNanoseconds();
+
+    for (int i = 0; i < config->operations; i++) {
+        long before = nowNanoseconds();
+        if (ops[i].command == 'q') {
+            long nodes = nodesVisited(sim);
+            AllocSimLifetime lifetime = hints && ops[i].longLived ? ALLOCSIM_LIFETIME_LONG : ALLOCSIM_LIFETIME_SHORT;
+            if (allocsim_request_hint(sim, ops[i].PID, ops[i].size, strategy, lifetime, NULL) != ALLOCSIM_OK) failed++;
+            visited += nodesVisited(sim) - nodes;
+            rq.latencies[rq.count++] = nowNanoseconds() - before;
+            requests++;
+        }
+        else if (ops[i].command == 'l') {
+            allocsim_release(sim, ops[i].PID);
+            rl.latencies[rl.count++] = nowNanoseconds() - before;
+        }
+        else if (ops[i].command == 'z') { // processes whose RQ failed are not found, like their RL
+            if (allocsim_resize(sim, ops[i].PID, ops[i].size, strategy, NULL) == ALLOCSIM_ERR_NO_MEMORY) failed++;
+            rs.latencies[rs.count++] = nowNanoseconds() - before;
+            requests++;
+        }
+        else {
+            allocsim_compact(sim, 0, NULL);
+            c.latencies[c.count++] = nowNanoseconds() - before;
+        }
+    }
+
+    double seconds = (nowNanoseconds() - start) / 1e9;
+    AllocSimStats stats;
+    allocsim_stats(sim, &stats);
+    allocsim_destroy(sim);
+
+    bool marked = (long) failed * 100 > (long) requests * FAILED_MARK_PERCENT;
+    char label[24];
+    sprintf(label, "%c%s%s%s%s", strategy, table ? "/soa" : "", quick ? "/fast" : "", hints ? "/hint" : "", marked ? " *" : "");
+    printf("%-15s %12.0f", label, config->operations / seconds);
+    printSamples(&rq);
+    printSamples(&rl);
+    printSamples(&c);
+    qsort(rs.latencies, rs.count, sizeof(long), compareLong); // RS has no p999 column
+    printf(" %8ld %8ld", percentile(&rs, 0.50), percentile(&rs, 0.99));
+    printf(" %10.1f %8d %10ld %12ld", rq.count ? (double) visited / rq.count : 0.0, failed, stats.internalFragmentation, stats.compactedBytes);
+    if (stats.quickRequests > 0) printf(" %8.1f%%", 100.0 * stats.quickHits / stats.quickRequests);
+    else printf(" %9s", "-");
+    if (stats.resizes > 0) printf(" %8.1f%%\n", 100.0 * stats.resizesInPlace / stats.resizes);
+    else printf(" %9s\n", "-");
+
+    free(rq.latencies);
+    free(rl.latencies);
+    free(c.latencies);
+    free(rs.latencies);
+    return marked;
+}
+
+// *************************************************************************************
+
+
+
+// ************************************* LOAD TEST *************************************
+
+typedef struct {
+    Config *config;
+    Operation *ops;   // workload of this client, PIDs are prefixed with the client number
+    char strategy;
+    Samples samples;  // round trip nanoseconds of every command
+    int failed;       // commands answered with ERR
+    long start, end;  // nanoseconds around the timed workload
+    bool connected;
+} LoadClient;
+
+// sends one command and waits for its reply line -> false if the daemon went away
+bool roundTrip(int fd, const char *command, char *reply, int replySize){
+    size_t length = strlen(command);
+    if (write(fd, command, length) != (ssize_t) length) return false;
+
+    int used = 0;
+    while (used == 0 || reply[used - 1] != '\n') {
+        ssize_t got = read(fd, reply + used, replySize - 1 - used);
+        if (got <= 0) return false;
+        used += got;
+    }
+    reply[used] = '\0';
+    return true;
+}
+
+void *loadClient(void *argument){
+    LoadClient *client = (LoadClient *) argument;
+    Config *config = client->config;
+    char command[64];
+    char reply[256];
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, config->socketPath, sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    client->connected = fd >= 0 && connect(fd, (struct sockaddr *) &address, sizeof(address)) == 0;
+    if (!client->connected) {
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+
+    client->start = nowNanoseconds();
+    for (int i = 0; i < config->operations; i++) {
+        Operation *op = &client->ops[i];
+        if (op->command == 'q') sprintf(command, "RQ %s %ld %c\n", op->PID, op->size, client->strategy);
+        else if (op->command == 'l') sprintf(command, "RL %s\n", op->PID);
+        else if (op->command == 'z') sprintf(command, "RS %s %ld %c\n", op->PID, op->size, client->strategy);
+        else strcpy(command, "C\n");
+
+        long before = nowNanoseconds();
+        if (!roundTrip(fd, command, reply, sizeof(reply))) break;
+        client->samples.latencies[client->samples.count++] = nowNanoseconds() - before;
+        if (strncmp(reply, "ERR", 3) == 0) client->failed++;
+    }
+    client->end = nowNanoseconds();
+
+    // leave the daemon empty for the next run, unanswered releases are fine
+    for (int i = 0; i < config->operations; i++) {
+        if (client->ops[i].command != 'q') continue;
+        sprintf(command, "RL %s\n", client->ops[i].PID);
+        if (!roundTrip(fd, command, reply, sizeof(reply))) break;
+    }
+
+    close(fd);
+    return NULL;
+}
+
+// runs every client count on every strategy -> each client replays its own copy of the workload
+bool loadTest(Config *config){
+    int maxClients = 0;
+    for (char *count = config->clientCounts; *count; count++) {
+        if (count == config->clientCounts || count[-1] == ',') {
+            if (atoi(count) > maxClients) maxClients = atoi(count);
+        }
+    }
+    if (maxClients <= 0) return false;
+
+    LoadClient *clients = (LoadClient *) calloc(maxClients, sizeof(LoadClient));
+    for (int k = 0; k < maxClients; k++) {
+        Config clientConfig = *config;
+        clientConfig.seed = config->seed + k; // different but repeatable workload per client
+        clients[k].config = config;
+        clients[k].ops = generateWorkload(&clientConfig);
+        clients[k].samples.latencies = (long *) malloc(sizeof(long) * config->operations);
+        for (int i = 0; i < config->operations; i++) { // hex keeps PIDs inside the simulator's 9 characters
+            Operation *op = &clients[k].ops[i];
+            snprintf(op->PID, sizeof(op->PID), "%x.%x", k, (unsigned) atoi(op->PID + 1));
+        }
+    }
+
+    printf("%-8s %8s %12s %26s %8s\n", "strategy", "clients", "ops/sec", "round trip ns p50/p99/p999", "failed");
+
+    for (int s = 0; config->strategies[s]; s++) {
+        char *count = config->clientCounts;
+        while (*count) {
+            int clientCount = atoi(count);
+            count += strcspn(count, ",");
+            if (*count) count++;
+            if (clientCount <= 0) continue;
+
+            pthread_t *threads = (pthread_t *) malloc(sizeof(pthread_t) * clientCount);
+            for (int k = 0; k < clientCount; k++) {
+                clients[k].strategy = config->strategies[s];
+                clients[k].samples.count = 0;
+                clients[k].failed = 0;
+                pthread_create(&threads[k], NULL, loadClient, &clients[k]);
+            }
+            for (int k = 0; k < clientCount; k++) pthread_join(threads[k], NULL);
+            free(threads);
+
+            // merge every client's samples for the percentiles
+            Samples all = { malloc(sizeof(long) * config->operations * clientCount), 0 };
+            int failed = 0;
+            long start = clients[0].start, end = clients[0].end;
+            for (int k = 0; k < clientCount; k++) {
+                if (!clients[k].connected) {
+                    fprintf(stderr, "ERROR: Could not connect to %s.\n", config->socketPath);
+                    return false;
+                }
+                memcpy(all.latencies + all.count, clients[k].samples.latencies, sizeof(long) * clients[k].samples.count);
+                all.count += clients[k].samples.count;
+                failed += clients[k].failed;
+                if (clients[k].start < start) start = clients[k].start;
+                if (clients[k].end > end) end = clients[k].end;
+            }
+            double seconds = (end - start) / 1e9;
+
+            printf("%-8c %8d %12.0f", config->strategies[s], clientCount, all.count / seconds);
+            printSamples(&all);
+            printf(" %8d\n", failed);
+            free(all.latencies);
+        }
+    }
+
+    for (int k = 0; k < maxClients; k++) {
+        free(clients[k].ops);
+        free(clients[k].samples.latencies);
+    }
+    free(clients);
+    return true;
+}
+
+// *************************************************************************************
+
+
+
+// ************************************** KERNELS **************************************
+
+#define KERNEL_QUERIES 200 // random first-fit sizes checked against the scalar kernel
+
+// times first-fit misses (whole map scans) and worst-fit on one map -> false if a kernel disagrees with scalar
+bool kernelBenchmark(Config *config, int blocks){
+    int padded = (blocks + 63) / 64 * 64; // kernels read whole bitmap words
+    long *limits = (long *) calloc(padded, sizeof(long));
+    unsigned long long *holes = (unsigned long long *) calloc(padded / 64, sizeof(unsigned long long));
+    long sizes[KERNEL_QUERIES];
+    int expected[KERNEL_QUERIES];
+    long expectedSteps[KERNEL_QUERIES];
+
+    rngState = config->seed;
+    for (int i = 0; i < blocks; i++) {
+        limits[i] = drawSize(config);
+        if (nextRandom() % 2) holes[i / 64] |= 1ULL << (i % 64); // half of the blocks are holes
+    }
+    for (int q = 0; q < KERNEL_QUERIES; q++) sizes[q] = drawSize(config);
+
+    const char *kernels[] = { "scalar", "avx2", "neon" };
+    double scalarScan = 0, scalarWorst = 0;
+    int expectedWorst = -1;
+    bool agree = true;
+    long visited = 0;
+
+    for (int k = 0; k < 3; k++) {
+        if (useTableKernel(kernels[k]) == NULL) continue; // not supported by this build or CPU
+
+        for (int q = 0; q < KERNEL_QUERIES; q++) { // same hole and same holes visited as scalar
+            long steps = 0;
+            int found = firstFitSearch(limits, holes, blocks, sizes[q], &steps);
+            if (k == 0) {
+                expected[q] = found;
+                expectedSteps[q] = steps;
+            }
+            else if (found != expected[q] || steps != expectedSteps[q]) agree = false;
+        }
+
+        // repeat until the timing is long enough to trust
+        int rounds = 0;
+        long start = nowNanoseconds();
+        do {
+            if (firstFitSearch(limits, holes, blocks, config->maxSize + 1, &visited) != -1) agree = false;
+            rounds++;
+        } while (nowNanoseconds() - start < 200000000L);
+        double scan = (double) (nowNanoseconds() - start) / rounds;
+
+        int worst = -1;
+        rounds = 0;
+        start = nowNanoseconds();
+        do {
+            worst = worstFitSearch(limits, holes, blocks, &visited);
+            rounds++;
+        } while (nowNanoseconds() - start < 200000000L);
+        double worstTime = (double) (nowNanoseconds() - start) / rounds;
+        if (k == 0) expectedWorst = worst;
+        else if (worst != expectedWorst) agree = false;
+
+        if (k == 0) {
+            scalarScan = scan;
+            scalarWorst = worstTime;
+        }
+        printf("%-8s %10d %14.0f %12.2f %8.2fx %14.0f %8.2fx\n", kernels[k], blocks, scan, blocks / scan,
+               scalarScan / scan, worstTime, scalarWorst / worstTime);
+    }
+
+    useTableKernel("auto");
+    free(limits);
+    free(holes);
+    if (!agree) fprintf(stderr, "ERROR: Kernels returned different holes for %d blocks.\n", blocks);
+    return agree;
+}
+
+// *************************************************************************************
+
+
+
+void printUsage(){
+    printf("usage: benchmark [-n ops] [-m memory] [-s uniform|power|bimodal|classes] [-min bytes] [-max bytes]\n"
+           "                 [-l exp|uniform|fixed|bimodal] [-L mean lifetime] [-c compact every] [-z resize percent] [-r seed]\n"
+           "                 [-t strategies] [-u daemon socket] [-k client counts, e.g. 1,2,4,8] [-a off|on|both] [-f off|on|both]\n"
+           "                 [-h off|on|both] [-K block counts, e.g. 100000,1000000]\n");
+}
+
+int main(int argc, char *argv[]) {
+    Config config = { 200000, 1 << 26, "uniform", 16, 8192, "exp", 2000, 0, 0, 1, "FBWYT", NULL, "1,2,4,8", "off", "off", "off", NULL };
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) { printUsage(); return 1; }
+        char *option = argv[i];
+        char *value = argv[++i];
+
+        if (strcmp(option, "-n") == 0) config.operations = atoi(value);
+        else if (strcmp(option, "-m") == 0) config.memory = atol(value);
+        else if (strcmp(option, "-s") == 0) config.sizeDist = value;
+        else if (strcmp(option, "-min") == 0) config.minSize = atol(value);
+        else if (strcmp(option, "-max") == 0) config.maxSize = atol(value);
+        else if (strcmp(option, "-l") == 0) config.lifeDist = value;
+        else if (strcmp(option, "-L") == 0) config.meanLife = atoi(value);
+        else if (strcmp(option, "-c") == 0) config.compactEvery = atoi(value);
+        else if (strcmp(option, "-z") == 0) config.resizePercent = atoi(value);
+        else if (strcmp(option, "-r") == 0) config.seed = strtoull(value, NULL, 10);
+        else if (strcmp(option, "-t") == 0) config.strategies = value;
+        else if (strcmp(option, "-u") == 0) config.socketPath = value;
+        else if (strcmp(option, "-k") == 0) config.clientCounts = value;
+        else if (strcmp(option, "-a") == 0) config.table = value;
+        else if (strcmp(option, "-f") == 0) config.quick = value;
+        else if (strcmp(option, "-h") == 0) config.hints = value;
+        else if (strcmp(option, "-K") == 0) config.kernelBlocks = value;
+        else { printUsage(); return 1; }
+    }
+    if (config.operations <= 0 || config.memory <= 0 || config.minSize <= 0 || config.maxSize < config.minSize || config.meanLife <= 0 ||
+        config.resizePercent < 0 || config.resizePercent > 100) {
+        printUsage();
+        return 1;
+    }
+    if (config.seed == 0) config.seed = 1; // xorshift never leaves zero
+
+    if (config.kernelBlocks != NULL) {
+        printf("sizes %s [%ld, %ld], half of the blocks are holes, first-fit misses scan the whole map\n",
+               config.sizeDist, config.minSize, config.maxSize);
+        printf("%-8s %10s %14s %12s %9s %14s %9s\n", "kernel", "blocks", "scan ns", "blocks/ns", "speedup", "worst-fit ns", "speedup");
+        bool agree = true;
+        for (char *count = config.kernelBlocks; *count; count += strcspn(count, ",") + (count[strcspn(count, ",")] != '\0')) {
+            if (atoi(count) > 0 && !kernelBenchmark(&config, atoi(count))) agree = false;
+        }
+        return agree ? 0 : 1;
+    }
+
+    if (config.socketPath != NULL) {
+        printf("%d ops per client, sizes %s [%ld, %ld], lifetime %s mean %d, compact every %d, daemon %s\n",
+               config.operations, config.sizeDist, config.minSize, config.maxSize,
+               config.lifeDist, config.meanLife, config.compactEvery, config.socketPath);
+        if (!loadTest(&config)) {
+            printUsage();
+            return 1;
+        }
+        return 0;
+    }
+
+    Operation *ops = generateWorkload(&config);
+
+    printf("%d ops, memory %ld, sizes %s [%ld, %ld], lifetime %s mean %d, compact every %d, resize %d%%\n",
+           config.operations, config.memory, config.sizeDist, config.minSize, config.maxSize,
+           config.lifeDist, config.meanLife, config.compactEvery, config.resizePercent);
+    printf("%-15s %12s %26s %26s %26s %17s %10s %8s %10s %12s %9s %9s\n", "strategy", "ops/sec",
+           "RQ ns p50/p99/p999", "RL ns p50/p99/p999", "C ns p50/p99/p999", "RS ns p50/p99", "nodes/RQ", "failed", "int.frag", "compacted", "quick.hit", "in.place");
+
+    bool marked = false;
+    for (int i = 0; config.strategies[i]; i++) {
+        for (int table = 0; table < 2; table++) {
+            if (strcmp(config.table, table ? "off" : "on") == 0) continue;
+            for (int quick = 0; quick < 2; quick++) {
+                if (strcmp(config.quick, quick ? "off" : "on") == 0) continue;
+                for (int hints = 0; hints < 2; hints++) {
+                    if (strcmp(config.hints, hints ? "off" : "on") == 0) continue;
+                    if (replay(&config, ops, config.strategies[i], table, quick, hints)) marked = true;
+                }
+            }
+        }
+    }
+
+    if (marked) printf("* more than %d%% of the requests failed -> ops/sec and latencies include the early exit of failed requests\n", FAILED_MARK_PERCENT);
+
+    free(ops);
+    return 0;
+}
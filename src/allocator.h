@@ -0,0 +1,73 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+// entry points of the simulator -> shared by the allocator program and the benchmark
+// every function works on its own Memory instance, so independent instances can run on different threads
+
+#include <stddef.h>
+
+typedef enum { false, true } bool; // for returning bool in isHole and hasEnoughSpace functions since I can't add the library stdbool.h based on assignment restrictions
+
+typedef struct Memory Memory; // one simulated memory with its blocks, indexes and counters
+
+Memory *createMemory(long total_memory, bool scripted_mode); // memory as one GIANT hole -> scripted_mode silences errors
+void destroyMemory(Memory *memory);                         // gives every block and index of memory back
+
+bool allocate(Memory *memory, char* PID, long size, char *type); // RQ -> false if request failed
+bool allocateHinted(Memory *memory, char* PID, long size, char *type, bool longLived); // RQ ... SHORT|LONG -> LONG is placed from the high end
+long allocateBatch(Memory *memory, char **PIDs, long *sizes, long count, char *type); // RQB -> number of requests placed, failures are printed with their PID
+bool deallocate(Memory *memory, char* PID);                     // RL -> false if release failed
+bool deallocateAt(Memory *memory, long address);                // RL @address -> false if no process starts at address
+bool reallocate(Memory *memory, char* PID, long size, char *type); // RS -> in place if the neighbouring holes allow it, type NULL for the default strategy
+void compact(Memory *memory, long targetHole);                  // C -> targetHole > 0 stops once such a hole exists
+void status(Memory *memory);                                    // STAT
+void statusRange(Memory *memory, long start, long end);         // STAT <start> <end> -> blocks overlapping the range
+void statusSummary(Memory *memory);                             // STAT SUMMARY
+void whoOwns(Memory *memory, long address);                     // WHO address
+void printStats(Memory *memory);                                // STATS
+void setBlockTable(Memory *memory, bool enabled);               // SOA ON|OFF -> first-fit scans an array copy of the list
+void setQuickLists(Memory *memory, bool enabled);               // FAST ON|OFF -> freed small blocks wait in per-size quick lists
+void consolidate(Memory *memory);                               // CONSOLIDATE -> merges every quick-listed block into the holes
+void setLegacyBestFit(Memory *memory, bool enabled);            // best-fit skips a hole spanning the whole memory like the original scan -> off by default
+bool saveMemory(Memory *memory, const char *path);              // SAVE <file> -> false if the file can't be written
+bool loadMemory(Memory *memory, const char *path);              // LOAD <file> -> memory is replaced by the snapshot, unchanged if it is invalid
+
+long internalFragmentation(Memory *memory); // bytes handed out to processes beyond what they requested
+long nodesVisited(Memory *memory);          // blocks and index nodes inspected while searching for holes
+
+void printError(Memory *memory, const char *error); // memory NULL -> always printed
+
+// profiling -> make PROFILE=1 defines ALLOCATOR_PROFILE, without it the macros compile to nothing
+#ifdef ALLOCATOR_PROFILE
+#include <stdio.h>
+long profileClock(void);                                                 // monotonic nanoseconds
+void profileCommand(Memory *memory, const char *name, long nanoseconds); // adds a dispatched command to its latency histogram
+void printProfile(Memory *memory, FILE *out, bool csv);                  // PROF -> counters and histograms as JSON or CSV
+#define PROFILE_START(clock) long clock = profileClock()
+#define PROFILE_COMMAND(memory, name, clock) profileCommand(memory, name, profileClock() - (clock))
+#else
+#define PROFILE_START(clock)
+#define PROFILE_COMMAND(memory, name, clock)
+#endif
+
+// PID interning -> memories give every block a small id, text scripts give every trace op one
+typedef struct {
+    char *strings;     // NUL terminated PIDs back to back
+    size_t used;       // bytes used in strings
+    size_t size;       // bytes allocated for strings
+    unsigned int count;
+    unsigned int *slots; // string offset + 1 of each id's string, 0 means empty
+    unsigned int *ids;   // id stored in each slot
+    size_t capacity;     // number of slots, power of two
+} PidInterner;
+
+size_t hashPID(const char *PID);                                // FNV-1a hash of PID string
+unsigned int internPID(PidInterner *interner, const char *PID); // id of PID -> new PIDs get consecutive ids from 0
+void freeInterner(PidInterner *interner);
+
+// block table search kernels -> limits padded to a multiple of 64 entries, bit i of holes marks entry i as a hole
+const char *useTableKernel(const char *name); // "auto", "scalar", "avx2" or "neon" -> kernel now in use, NULL if not supported
+int firstFitSearch(const long *limits, const unsigned long long *holes, int count, long size, long *visited); // lowest fitting hole, -1 if none
+int worstFitSearch(const long *limits, const unsigned long long *holes, int count, long *visited);          // lowest biggest hole, -1 if none
+
+#endif
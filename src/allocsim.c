@@ -0,0 +1,2871 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "allocator.h"
+#include "allocsim.h"
+
+const char *HOLE_PID = "Unused";
+#define HOLE_ID 0 // interned id of HOLE_PID -> every memory interns it first
+#define FAST_ID UINT_MAX // pid of a freed block parked in a quick list -> internPID never hands it out
+
+// *************************************** TREAP ***************************************
+// intrusive randomized balanced search tree -> nodes are embedded inside the structures they index
+// expected O(log n) insert, remove and lookup; ordering is decided by the compare function of the tree
+
+typedef struct TreapNode {
+    struct TreapNode *left;  // pointer to left child (smaller keys)
+    struct TreapNode *right; // pointer to right child (bigger keys)
+    unsigned int priority;   // random heap priority -> keeps the tree balanced in expectation
+} TreapNode;
+
+typedef int (*TreapCompare)(const TreapNode *a, const TreapNode *b); // <0, 0, >0 like strcmp
+
+typedef struct {
+    TreapNode *root;      // pointer to root node -> NULL if tree is empty
+    TreapCompare compare; // ordering of the tree
+    unsigned int seed;    // state of the priority generator
+    long visited;         // nodes inspected by lookups
+} Treap;
+
+void treapInit(Treap *tree, TreapCompare compare){
+    tree->root = NULL;
+    tree->compare = compare;
+    tree->seed = 2463534242u; // fixed seed so runs are reproducible
+    tree->visited = 0;
+}
+
+// xorshift random number generator for treap priorities
+unsigned int treapRandom(Treap *tree){
+    tree->seed ^= tree->seed << 13;
+    tree->seed ^= tree->seed >> 17;
+    tree->seed ^= tree->seed << 5;
+    return tree->seed;
+}
+
+TreapNode *treapRotateRight(TreapNode *node){
+    TreapNode *left = node->left;
+    node->left = left->right;
+    left->right = node;
+    return left; // left child becomes new subtree root
+}
+
+TreapNode *treapRotateLeft(TreapNode *node){
+    TreapNode *right = node->right;
+    node->right = right->left;
+    right->left = node;
+    return right; // right child becomes new subtree root
+}
+
+TreapNode *treapInsertAt(TreapNode *root, TreapNode *node, TreapCompare compare){
+    if (root == NULL) return node; // found empty spot
+
+    if (compare(node, root) < 0) {
+        root->left = treapInsertAt(root->left, node, compare);
+        if (root->left->priority > root->priority) root = treapRotateRight(root); // restore heap order
+    } else {
+        root->right = treapInsertAt(root->right, node, compare);
+        if (root->right->priority > root->priority) root = treapRotateLeft(root); // restore heap order
+    }
+    return root;
+}
+
+TreapNode *treapRemoveAt(TreapNode *root, TreapNode *node, TreapCompare compare){
+    if (root == NULL) return NULL; // node is not in the tree
+
+    if (root == node) {
+        // rotate node down until it has at most one child, then unlink it
+        if (root->left == NULL) return root->right;
+        if (root->right == NULL) return root->left;
+        if (root->left->priority > root->right->priority) {
+            root = treapRotateRight(root);
+            root->right = treapRemoveAt(root->right, node, compare);
+        } else {
+            root = treapRotateLeft(root);
+            root->left = treapRemoveAt(root->left, node, compare);
+        }
+    } else if (compare(node, root) < 0) {
+        root->left = treapRemoveAt(root->left, node, compare);
+    } else {
+        root->right = treapRemoveAt(root->right, node, compare);
+    }
+    return root;
+}
+
+void treapInsert(Treap *tree, TreapNode *node){
+    node->left = NULL;
+    node->right = NULL;
+    node->priority = treapRandom(tree);
+    tree->root = treapInsertAt(tree->root, node, tree->compare);
+}
+
+// node keys must not be changed while node is inside the tree -> remove, update keys, insert again
+void treapRemove(Treap *tree, TreapNode *node){
+    tree->root = treapRemoveAt(tree->root, node, tree->compare);
+}
+
+// returns the smallest node that is not smaller than probe -> NULL if every node is smaller
+TreapNode *treapLowerBound(Treap *tree, const TreapNode *probe){
+    TreapNode *current = tree->root;
+    TreapNode *found = NULL;
+
+    while (current != NULL) {
+        tree->visited++;
+        if (tree->compare(current, probe) >= 0) {
+            found = current; // candidate, look for a smaller one on the left
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+    return found;
+}
+
+// returns the biggest node of the tree -> NULL if tree is empty
+TreapNode *treapMax(Treap *tree){
+    TreapNode *current = tree->root;
+    if (current == NULL) return NULL;
+    while (current->right != NULL) {
+        tree->visited++;
+        current = current->right;
+    }
+    return current;
+}
+
+// *************************************************************************************
+
+
+
+// *************************************** BLOCK ***************************************
+// doubly linked list structure for memory -> blocks are nodes
+typedef struct Block {
+    char PID[10];         // process id name -> "Unused" if unused
+    unsigned int pid;     // interned id of PID -> HOLE_ID if unused
+    long base;  // start address
+    long limit; // number of bytes 
+    struct Block *prev; // pointer to previous block
+    struct Block *next;   // pointer to next block
+    TreapNode sizeNode; // node in memory->holesBySize -> only used while block is a hole
+    TreapNode addressNode; // node in memory->blocksByAddress -> every block
+    struct Block *freePrev; // pointer to previous hole of the same free list -> buddy and TLSF engines
+    struct Block *freeNext; // pointer to next hole of the same free list -> buddy and TLSF engines
+    long requested; // number of bytes the process asked for -> less than limit if the engine rounds up
+    bool longLived; // process was requested with a LONG hint -> placed from the high end and compacted towards it
+} Block;
+
+// gets the block that owns an embedded size index node
+#define blockFromSizeNode(node) ((Block *) ((char *) (node) - offsetof(Block, sizeNode)))
+#define blockFromAddressNode(node) ((Block *) ((char *) (node) - offsetof(Block, addressNode)))
+
+// checks if memory block is a hole
+bool isHole(Block *b){ return b->pid == HOLE_ID; }
+
+// checks if memory block was freed into a quick list and is not merged yet
+bool isFast(Block *b){ return b->pid == FAST_ID; }
+
+// checks if no process owns memory block
+bool isFree(Block *b){ return isHole(b) || isFast(b); }
+
+// renames a block -> pid must be the interned id of PID
+void setBlockPID(Block *b, const char *PID, unsigned int pid){
+    strcpy(b->PID, PID);
+    b->pid = pid;
+}
+
+// checks if memory block has enough space
+bool hasEnoughSpace (Block *b, long size){ return b->limit >= size; }
+
+// STAT lines are collected in a big buffer and written with one fwrite -> no printf per block
+#define STAT_BUFFER_SIZE (1 << 16)
+#define STAT_LINE_MAX 96 // longest line printBlock writes -> two 19 digit addresses and a PID
+
+typedef struct {
+    char data[STAT_BUFFER_SIZE];
+    size_t used;
+} StatBuffer;
+
+void statFlush(StatBuffer *buffer){
+    fwrite(buffer->data, 1, buffer->used, stdout);
+    buffer->used = 0;
+}
+
+void statText(StatBuffer *buffer, const char *text){
+    size_t length = strlen(text);
+    memcpy(buffer->data + buffer->used, text, length);
+    buffer->used += length;
+}
+
+// writes a non negative number in decimal
+void statNumber(StatBuffer *buffer, long value){
+    char digits[24];
+    int count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) buffer->data[buffer->used++] = digits[--count];
+}
+
+// printer for block to use for STAT
+void printBlock(StatBuffer *buffer, const AllocSimBlock *b) {
+    if (buffer->used + STAT_LINE_MAX > STAT_BUFFER_SIZE) statFlush(buffer);
+
+    statText(buffer, "Addresses [");
+    statNumber(buffer, b->base);
+    statText(buffer, ":");
+    statNumber(buffer, b->base + b->limit - 1);
+    if (b->PID == NULL) {
+        statText(buffer, "] Unused\n"); // handles hole case print
+    } else {
+        statText(buffer, "] Process "); // handles non-hole case print
+        statText(buffer, b->PID);
+        statText(buffer, "\n");
+    }
+}
+
+// *************************************************************************************
+
+
+
+// ************************************* BLOCK POOL ************************************
+// free list backed node pool -> blocks are carved out of big chunks instead of one malloc per block
+
+#define BLOCK_POOL_CHUNK 1024 // number of blocks in each chunk
+
+typedef struct BlockChunk {
+    struct BlockChunk *next; // pointer to previously allocated chunk
+    Block blocks[BLOCK_POOL_CHUNK];
+} BlockChunk;
+
+typedef struct {
+    BlockChunk *chunks; // every chunk allocated so far
+    int unused;         // number of never used blocks left at the end of the newest chunk
+    Block *freeList;    // released blocks, linked through their next pointer
+    long live;          // number of blocks currently handed out
+    long highWater;     // maximum number of blocks handed out at the same time
+    long hits;          // requests served from the free list
+    long misses;        // requests that had to carve a fresh block
+    long chunkCount;    // number of chunks malloc'd
+} BlockPool;
+
+// takes a block from the pool
+Block *poolAlloc(BlockPool *pool){
+    Block *block;
+
+    if (pool->freeList != NULL) { // reuse a released block
+        block = pool->freeList;
+        pool->freeList = block->next;
+        pool->hits++;
+    } else {
+        if (pool->unused == 0) { // newest chunk is used up -> grow pool by one chunk
+            BlockChunk *chunk = (BlockChunk *) malloc(sizeof(BlockChunk));
+            chunk->next = pool->chunks;
+            pool->chunks = chunk;
+            pool->unused = BLOCK_POOL_CHUNK;
+            pool->chunkCount++;
+        }
+        block = &pool->chunks->blocks[BLOCK_POOL_CHUNK - pool->unused];
+        pool->unused--;
+        pool->misses++;
+    }
+
+    pool->live++;
+    if (pool->live > pool->highWater) pool->highWater = pool->live;
+    return block;
+}
+
+// gives a block back to the pool
+void poolFree(BlockPool *pool, Block *block){
+    block->next = pool->freeList;
+    pool->freeList = block;
+    pool->live--;
+}
+
+// gives every chunk back -> blocks of the pool must not be used anymore
+void poolDestroy(BlockPool *pool){
+    while (pool->chunks != NULL) {
+        BlockChunk *next = pool->chunks->next;
+        free(pool->chunks);
+        pool->chunks = next;
+    }
+}
+
+// block constructor
+Block *createBlock(BlockPool *pool, const char *PID, unsigned int pid, long base, long limit) {
+    Block *newBlock = poolAlloc(pool); // take memory to hold a Block from the pool
+    setBlockPID(newBlock, PID, pid); // set process id name of the new block
+    newBlock->base = base; // set base
+    newBlock->limit = limit; // set limit
+    newBlock->longLived = false;
+    newBlock->prev = NULL; // set new block's prev pointer to null
+    newBlock->next = NULL; // set new block's next pointer to null
+    return newBlock; // return pointer to new block
+}
+
+// block destructor
+void destroyBlock(BlockPool *pool, Block *b){ poolFree(pool, b); }
+
+// *************************************************************************************
+
+
+
+// ************************************** PID TABLE ************************************
+// open addressing hash table from PID to process block -> linear probing, no tombstones
+
+#define PID_TABLE_MIN_CAPACITY 64 // capacity is always a power of two
+
+typedef struct {
+    Block **slots;   // NULL means empty slot
+    size_t capacity; // number of slots
+    size_t count;    // number of processes in table
+} PidTable;
+
+// FNV-1a hash of PID string
+size_t hashPID(const char *PID){
+    size_t hash = 2166136261u;
+    for (int i = 0; PID[i]; i++) {
+        hash ^= (unsigned char) PID[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void pidTableInit(PidTable *table, size_t capacity){
+    table->slots = (Block **) calloc(capacity, sizeof(Block *)); // all slots empty
+    table->capacity = capacity;
+    table->count = 0;
+}
+
+// returns slot index holding PID, or the empty slot where PID would be inserted
+size_t pidTableSlot(PidTable *table, const char *PID){
+    size_t mask = table->capacity - 1;
+    size_t i = hashPID(PID) & mask;
+
+    while (table->slots[i] != NULL && strcmp(table->slots[i]->PID, PID) != 0) {
+        i = (i + 1) & mask; // probe next slot
+    }
+    return i;
+}
+
+Block *pidTableFind(PidTable *table, const char *PID){
+    return table->slots[pidTableSlot(table, PID)];
+}
+
+void pidTableInsert(PidTable *table, Block *process);
+
+// doubles capacity and re-inserts every process
+void pidTableGrow(PidTable *table){
+    Block **oldSlots = table->slots;
+    size_t oldCapacity = table->capacity;
+
+    pidTableInit(table, oldCapacity * 2);
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i] != NULL) pidTableInsert(table, oldSlots[i]);
+    }
+    free(oldSlots);
+}
+
+// inserts or updates the block stored for process->PID
+void pidTableInsert(PidTable *table, Block *process){
+    if ((table->count + 1) * 2 > table->capacity) pidTableGrow(table); // keep load factor under 1/2
+
+    size_t i = pidTableSlot(table, process->PID);
+    if (table->slots[i] == NULL) table->count++;
+    table->slots[i] = process;
+}
+
+// removes PID from table -> later entries of the probe run are shifted back so lookups never stop early
+void pidTableRemove(PidTable *table, const char *PID){
+    size_t mask = table->capacity - 1;
+    size_t i = pidTableSlot(table, PID);
+    if (table->slots[i] == NULL) return; // PID is not in table
+
+    table->slots[i] = NULL;
+    table->count--;
+
+    size_t j = i;
+    while (1) {
+        j = (j + 1) & mask;
+        if (table->slots[j] == NULL) return; // end of probe run
+
+        size_t home = hashPID(table->slots[j]->PID) & mask;
+        // move entry j into hole i if its home slot is not inside the cyclic range (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            table->slots[i] = table->slots[j];
+            table->slots[j] = NULL;
+            i = j;
+        }
+    }
+}
+
+// empties the table without shrinking it
+void pidTableClear(PidTable *table){
+    memset(table->slots, 0, table->capacity * sizeof(Block *));
+    table->count = 0;
+}
+
+// interns PID strings into consecutive ids -> used by memories for Block->pid and by traces parsed from text
+unsigned int internPID(PidInterner *interner, const char *PID){
+    if ((interner->count + 1) * 2 > interner->capacity) { // grow and rehash
+        size_t oldCapacity = interner->capacity;
+        unsigned int *oldSlots = interner->slots;
+        unsigned int *oldIds = interner->ids;
+
+        interner->capacity = oldCapacity ? oldCapacity * 2 : 1024;
+        interner->slots = (unsigned int *) calloc(interner->capacity, sizeof(unsigned int));
+        interner->ids = (unsigned int *) malloc(interner->capacity * sizeof(unsigned int));
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldSlots[i] == 0) continue;
+            size_t j = hashPID(interner->strings + oldSlots[i] - 1) & (interner->capacity - 1);
+            while (interner->slots[j] != 0) j = (j + 1) & (interner->capacity - 1);
+            interner->slots[j] = oldSlots[i];
+            interner->ids[j] = oldIds[i];
+        }
+        free(oldSlots);
+        free(oldIds);
+    }
+
+    size_t mask = interner->capacity - 1;
+    size_t i = hashPID(PID) & mask;
+    while (interner->slots[i] != 0) {
+        if (strcmp(interner->strings + interner->slots[i] - 1, PID) == 0) return interner->ids[i]; // already interned
+        i = (i + 1) & mask;
+    }
+
+    size_t length = strlen(PID) + 1;
+    while (interner->used + length > interner->size) {
+        interner->size = interner->size ? interner->size * 2 : 4096;
+        interner->strings = (char *) realloc(interner->strings, interner->size);
+    }
+    memcpy(interner->strings + interner->used, PID, length);
+    interner->slots[i] = interner->used + 1;
+    interner->ids[i] = interner->count;
+    interner->used += length;
+    return interner->count++;
+}
+
+void freeInterner(PidInterner *interner){
+    free(interner->strings);
+    free(interner->slots);
+    free(interner->ids);
+}
+
+// *************************************************************************************
+
+
+
+// **************************************** TLSF ***************************************
+// two level segregated fit -> holes are kept in free lists by size class, bitmaps tell which lists are not empty
+// first level splits sizes by power of two, second level splits every power of two range linearly
+
+#define TLSF_SL_LOG2 4                       // 16 second level classes per first level class
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_SMALL_SIZE TLSF_SL_COUNT        // sizes below this are mapped one byte per class
+#define TLSF_FL_COUNT (63 - TLSF_SL_LOG2 + 1) // enough classes for every positive long size
+
+typedef struct {
+    unsigned long long flBitmap;         // bit fl is set if any list of first level class fl is not empty
+    unsigned int slBitmap[TLSF_FL_COUNT]; // bit sl is set if list [fl][sl] is not empty
+    Block *lists[TLSF_FL_COUNT][TLSF_SL_COUNT]; // hole free lists, linked through freePrev and freeNext
+    long largest;       // size of the biggest hole -> only valid while largestStale is false
+    long largestCount;  // holes of exactly that size
+    bool largestStale;  // the last hole of the biggest size left -> tlsfLargest finds the new one
+} Tlsf;
+
+// index of the most significant set bit
+int tlsfFls(unsigned long long x){ return 63 - __builtin_clzll(x); }
+
+// index of the least significant set bit -> find first set
+int tlsfFfs(unsigned long long x){ return __builtin_ctzll(x); }
+
+// size class that a hole of the given size belongs to
+void tlsfMapping(long size, int *fl, int *sl){
+    if (size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size;
+    } else {
+        int msb = tlsfFls(size);
+        *fl = msb - TLSF_SL_LOG2 + 1;
+        *sl = (size >> (msb - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT; // bits right after the most significant one
+    }
+}
+
+void tlsfInsert(Tlsf *tlsf, Block *hole){
+    int fl, sl;
+    tlsfMapping(hole->limit, &fl, &sl);
+
+    hole->freePrev = NULL;
+    hole->freeNext = tlsf->lists[fl][sl];
+    if (hole->freeNext != NULL) hole->freeNext->freePrev = hole;
+    tlsf->lists[fl][sl] = hole;
+
+    tlsf->flBitmap |= 1ULL << fl;
+    tlsf->slBitmap[fl] |= 1u << sl;
+
+    if (tlsf->largestStale) return; // recounted on the next query anyway
+    if (hole->limit > tlsf->largest) {
+        tlsf->largest = hole->limit;
+        tlsf->largestCount = 1;
+    } else if (hole->limit == tlsf->largest) tlsf->largestCount++;
+}
+
+// call before changing the hole's limit
+void tlsfRemove(Tlsf *tlsf, Block *hole){
+    int fl, sl;
+    tlsfMapping(hole->limit, &fl, &sl);
+
+    if (hole->freePrev == NULL) tlsf->lists[fl][sl] = hole->freeNext; // hole was first of the list
+    else hole->freePrev->freeNext = hole->freeNext;
+    if (hole->freeNext != NULL) hole->freeNext->freePrev = hole->freePrev;
+
+    if (tlsf->lists[fl][sl] == NULL) { // list became empty -> clear its bits
+        tlsf->slBitmap[fl] &= ~(1u << sl);
+        if (tlsf->slBitmap[fl] == 0) tlsf->flBitmap &= ~(1ULL << fl);
+    }
+
+    if (!tlsf->largestStale && hole->limit == tlsf->largest && --tlsf->largestCount == 0) tlsf->largestStale = true;
+}
+
+// size of the biggest hole -> O(1) unless the last hole of the biggest size left since the previous call,
+// then the list of the highest non-empty class is scanned once
+long tlsfLargest(Tlsf *tlsf){
+    if (!tlsf->largestStale) return tlsf->largest;
+
+    tlsf->largest = 0;
+    tlsf->largestCount = 0;
+    tlsf->largestStale = false;
+    if (tlsf->flBitmap == 0) return 0;
+
+    int fl = tlsfFls(tlsf->flBitmap);
+    for (Block *b = tlsf->lists[fl][tlsfFls(tlsf->slBitmap[fl])]; b != NULL; b = b->freeNext) {
+        if (b->limit > tlsf->largest) {
+            tlsf->largest = b->limit;
+            tlsf->largestCount = 1;
+        } else if (b->limit == tlsf->largest) tlsf->largestCount++;
+    }
+    return tlsf->largest;
+}
+
+// finds a hole of at least size bytes in O(1) -> NULL if none is found
+Block *tlsfFind(Tlsf *tlsf, long size){
+    int fl, sl;
+    tlsfMapping(size, &fl, &sl);
+    Block *sameClass = tlsf->lists[fl][sl]; // holes of this class may be smaller than size
+
+    // round size up to the next class so every hole of the found class fits
+    long rounded = size;
+    if (size >= TLSF_SMALL_SIZE) {
+        long step = (1L << (tlsfFls(size) - TLSF_SL_LOG2)) - 1;
+        rounded = size > LONG_MAX - step ? -1 : size + step; // -1 -> no bigger class exists
+    }
+
+    if (rounded > 0) {
+        tlsfMapping(rounded, &fl, &sl);
+
+        unsigned int slMap = sl < TLSF_SL_COUNT ? tlsf->slBitmap[fl] & (~0u << sl) : 0;
+        if (slMap == 0) { // no list left in this first level class -> go to a bigger one
+            unsigned long long flMap = fl + 1 < 64 ? tlsf->flBitmap & (~0ULL << (fl + 1)) : 0;
+            if (flMap != 0) {
+                fl = tlsfFfs(flMap);
+                slMap = tlsf->slBitmap[fl];
+            }
+        }
+        if (slMap != 0) return tlsf->lists[fl][tlsfFfs(slMap)];
+    }
+
+    // no bigger class has a hole -> the first hole of size's own class may still fit
+    if (sameClass != NULL && sameClass->limit >= size) return sameClass;
+    return NULL;
+}
+
+// *************************************************************************************
+
+
+
+// ************************************* BLOCK TABLE ***********************************
+// structure of arrays copy of the block list in address order -> first-fit reads contiguous limits and
+// skips 64 processes at a time through the hole bitmap instead of chasing next pointers
+// splits and merges shift the arrays with memmove, so the table is optional -> SOA ON|OFF
+
+#define TABLE_WORD(i) ((i) / 64)         // bitmap word of entry i
+#define TABLE_BIT(i) (1ULL << ((i) % 64)) // bit of entry i inside its word
+
+typedef struct {
+    long *bases;               // start address of every block
+    long *limits;              // number of bytes of every block
+    unsigned long long *holes; // bit i is set if block i is a hole -> bits at and above count are 0
+    Block **nodes;             // list node of every block
+    int count;                 // number of blocks
+    int capacity;              // number of entries allocated -> multiple of 64
+} BlockTable;
+
+// makes room for one more entry
+void tableReserve(BlockTable *table){
+    if (table->count < table->capacity) return;
+
+    int capacity = table->capacity ? table->capacity * 2 : 1024;
+    table->bases = (long *) realloc(table->bases, sizeof(long) * capacity);
+    table->limits = (long *) realloc(table->limits, sizeof(long) * capacity);
+    table->nodes = (Block **) realloc(table->nodes, sizeof(Block *) * capacity);
+    memset(table->limits + table->capacity, 0, sizeof(long) * (capacity - table->capacity)); // kernels read whole words
+    table->holes = (unsigned long long *) realloc(table->holes, sizeof(unsigned long long) * TABLE_WORD(capacity));
+    memset(table->holes + TABLE_WORD(table->capacity), 0, sizeof(unsigned long long) * TABLE_WORD(capacity - table->capacity));
+    table->capacity = capacity;
+}
+
+// copies a block into entry i
+void tableSet(BlockTable *table, int i, Block *b){
+    table->bases[i] = b->base;
+    table->limits[i] = b->limit;
+    table->nodes[i] = b;
+    if (isHole(b)) table->holes[TABLE_WORD(i)] |= TABLE_BIT(i);
+    else table->holes[TABLE_WORD(i)] &= ~TABLE_BIT(i);
+}
+
+// finds the entry of the block starting at base -> binary search since entries are in address order
+int tableFind(BlockTable *table, long base){
+    int low = 0, high = table->count - 1;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (table->bases[middle] < base) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+// inserts a block as entry i -> entries at and after i move one up
+void tableInsert(BlockTable *table, int i, Block *b){
+    tableReserve(table);
+
+    int moved = table->count - i;
+    memmove(table->bases + i + 1, table->bases + i, sizeof(long) * moved);
+    memmove(table->limits + i + 1, table->limits + i, sizeof(long) * moved);
+    memmove(table->nodes + i + 1, table->nodes + i, sizeof(Block *) * moved);
+
+    // shift hole bits at and above i up by one, highest word first
+    for (int word = TABLE_WORD(table->count); word > TABLE_WORD(i); word--) {
+        table->holes[word] = (table->holes[word] << 1) | (table->holes[word - 1] >> 63);
+    }
+    unsigned long long below = TABLE_BIT(i) - 1;
+    unsigned long long *word = &table->holes[TABLE_WORD(i)];
+    *word = (*word & below) | ((*word & ~below) << 1);
+
+    table->count++;
+    tableSet(table, i, b);
+}
+
+// removes entry i -> entries after i move one down
+void tableRemove(BlockTable *table, int i){
+    int moved = table->count - i - 1;
+    memmove(table->bases + i, table->bases + i + 1, sizeof(long) * moved);
+    memmove(table->limits + i, table->limits + i + 1, sizeof(long) * moved);
+    memmove(table->nodes + i, table->nodes + i + 1, sizeof(Block *) * moved);
+
+    // shift hole bits above i down by one, lowest word first
+    unsigned long long below = TABLE_BIT(i) - 1;
+    unsigned long long *word = &table->holes[TABLE_WORD(i)];
+    *word = (*word & below) | ((*word >> 1) & ~below);
+    for (int next = TABLE_WORD(i) + 1; next <= TABLE_WORD(table->count - 1); next++) {
+        table->holes[next - 1] |= table->holes[next] << 63;
+        table->holes[next] >>= 1;
+    }
+
+    table->count--;
+}
+
+// copies the whole block list again -> used after compaction and engine changes
+void tableRebuild(BlockTable *table, Block *head){
+    if (table->capacity > 0) memset(table->holes, 0, sizeof(unsigned long long) * TABLE_WORD(table->capacity)); // never allocated before the first rebuild
+    table->count = 0;
+    for (Block *current = head; current != NULL; current = current->next) {
+        tableReserve(table);
+        tableSet(table, table->count++, current);
+    }
+}
+
+// search kernels over the table arrays -> limits are padded to a multiple of 64 entries, so every kernel
+// reads whole bitmap words, and visited counts the holes a scalar walk inspects whatever kernel runs
+typedef int (*FirstFitKernel)(const long *limits, const unsigned long long *holes, int count, long size, long *visited);
+typedef long (*MaxHoleKernel)(const long *limits, const unsigned long long *holes, int count);
+
+// scalar first-fit -> walks the set bits of every word
+int firstFitScalar(const long *limits, const unsigned long long *holes, int count, long size, long *visited){
+    for (int word = 0; word < TABLE_WORD(count + 63); word++) {
+        for (unsigned long long bits = holes[word]; bits != 0; bits &= bits - 1) { // set bits low to high
+            int i = word * 64 + __builtin_ctzll(bits);
+            (*visited)++;
+            if (limits[i] >= size) return i;
+        }
+    }
+    return -1;
+}
+
+// biggest hole limit -> 0 if there is no hole
+long maxHoleScalar(const long *limits, const unsigned long long *holes, int count){
+    long max = 0;
+    for (int word = 0; word < TABLE_WORD(count + 63); word++) {
+        for (unsigned long long bits = holes[word]; bits != 0; bits &= bits - 1) {
+            int i = word * 64 + __builtin_ctzll(bits);
+            if (limits[i] > max) max = limits[i];
+        }
+    }
+    return max;
+}
+
+// entry of the lowest hole of a word that fits -> counts the holes up to it like the scalar walk
+int firstFitHit(unsigned long long holes, int word, unsigned long long fits, long *visited){
+    unsigned long long hit = fits & -fits;
+    *visited += __builtin_popcountll(holes & (hit | (hit - 1)));
+    return word * 64 + __builtin_ctzll(fits);
+}
+
+#if defined(__x86_64__) && !defined(ALLOCATOR_NO_SIMD)
+#include <immintrin.h>
+
+// bit i is set if limits[i] >= size -> sixteen compares of four limits cover one bitmap word
+__attribute__((target("avx2")))
+static inline unsigned long long fitMaskAvx2(const long *limits, __m256i below){
+    unsigned long long mask = 0;
+    for (int part = 0; part < 16; part++) {
+        __m256i fits = _mm256_cmpgt_epi64(_mm256_loadu_si256((const __m256i *) (limits + part * 4)), below);
+        mask |= (unsigned long long) _mm256_movemask_pd(_mm256_castsi256_pd(fits)) << (part * 4);
+    }
+    return mask;
+}
+
+__attribute__((target("avx2")))
+int firstFitAvx2(const long *limits, const unsigned long long *holes, int count, long size, long *visited){
+    __m256i below = _mm256_set1_epi64x(size - 1); // limit > size - 1 is limit >= size
+    for (int word = 0; word < TABLE_WORD(count + 63); word++) {
+        if (holes[word] == 0) continue;
+        unsigned long long fits = holes[word] & fitMaskAvx2(limits + word * 64, below);
+        if (fits != 0) return firstFitHit(holes[word], word, fits, visited);
+        *visited += __builtin_popcountll(holes[word]);
+    }
+    return -1;
+}
+
+__attribute__((target("avx2")))
+long maxHoleAvx2(const long *limits, const unsigned long long *holes, int count){
+    const __m256i weights = _mm256_setr_epi64x(1, 2, 4, 8);
+    __m256i max = _mm256_setzero_si256();
+    for (int word = 0; word < TABLE_WORD(count + 63); word++) {
+        if (holes[word] == 0) continue;
+        for (int part = 0; part < 16; part++) {
+            // spread 4 hole bits over 4 lanes, processes become 0 which never wins
+            __m256i bits = _mm256_set1_epi64x((long long) ((holes[word] >> (part * 4)) & 0xf));
+            __m256i hole = _mm256_cmpeq_epi64(_mm256_and_si256(bits, weights), weights);
+            __m256i values = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) (limits + word * 64 + part * 4)), hole);
+            max = _mm256_blendv_epi8(max, values, _mm256_cmpgt_epi64(values, max)); // no 64 bit max in AVX2
+        }
+    }
+    long lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, max);
+    long result = lanes[0];
+    for (int lane = 1; lane < 4; lane++) if (lanes[lane] > result) result = lanes[lane];
+    return result;
+}
+
+#elif defined(__aarch64__) && !defined(ALLOCATOR_NO_SIMD)
+#include <arm_neon.h>
+
+// narrows two 64 bit compare results to four 32 bit lanes
+static inline uint32x4_t narrowFits(uint64x2_t low, uint64x2_t high){ return vcombine_u32(vmovn_u64(low), vmovn_u64(high)); }
+
+// bit i is set if limits[i] >= size for 16 limits -> compares are narrowed to bytes and weighted like a movemask
+static inline unsigned long long fitMaskNeon(const long *limits, int64x2_t sizes){
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint32x4_t fits[4];
+    for (int part = 0; part < 4; part++) {
+        fits[part] = narrowFits(vcgeq_s64(vld1q_s64(limits + part * 4), sizes), vcgeq_s64(vld1q_s64(limits + part * 4 + 2), sizes));
+    }
+    uint16x8_t low = vcombine_u16(vmovn_u32(fits[0]), vmovn_u32(fits[1]));
+    uint16x8_t high = vcombine_u16(vmovn_u32(fits[2]), vmovn_u32(fits[3]));
+    uint8x16_t bits = vandq_u8(vcombine_u8(vmovn_u16(low), vmovn_u16(high)), vld1q_u8(weights));
+    return vaddv_u8(vget_low_u8(bits)) | (unsigned long long) vaddv_u8(vget_high_u8(bits)) << 8;
+}
+
+int firstFitNeon(const long *limits, const unsigned long long *holes, int count, long size, long *visited){
+    int64x2_t sizes = vdupq_n_s64(size);
+    for (int word = 0; word < TABLE_WORD(count + 63); word++) {
+        if (holes[word] == 0) continue;
+        unsigned long long fits = 0;
+        for (int part = 0; part < 4; part++) fits |= fitMaskNeon(limits + word * 64 + part * 16, sizes) << (part * 16);
+        fits &= holes[word];
+        if (fits != 0) return firstFitHit(holes[word], word, fits, visited);
+        *visited += __builtin_popcountll(holes[word]);
+    }
+    return -1;
+}
+
+long maxHoleNeon(const long *limits, const unsigned long long *holes, int count){
+    static const uint64_t weightValues[2] = { 1, 2 };
+    uint64x2_t weights = vld1q_u64(weightValues);
+    int64x2_t max = vdupq_n_s64(0);
+    for (int word = 0; word < TABLE_WORD(count + 63); word++) {
+        if (holes[word] == 0) continue;
+        for (int part = 0; part < 32; part++) {
+            // spread 2 hole bits over 2 lanes, processes become 0 which never wins
+            uint64x2_t bits = vdupq_n_u64((holes[word] >> (part * 2)) & 0x3);
+            uint64x2_t hole = vceqq_u64(vandq_u64(bits, weights), weights);
+            int64x2_t values = vandq_s64(vld1q_s64(limits + word * 64 + part * 2), vreinterpretq_s64_u64(hole));
+            max = vbslq_s64(vcgtq_s64(values, max), values, max); // no 64 bit max in NEON
+        }
+    }
+    return vgetq_lane_s64(max, 0) > vgetq_lane_s64(max, 1) ? vgetq_lane_s64(max, 0) : vgetq_lane_s64(max, 1);
+}
+#endif
+
+FirstFitKernel firstFitKernel = firstFitScalar; // kernel picked by useTableKernel
+MaxHoleKernel maxHoleKernel = maxHoleScalar;
+const char *tableKernelName = "scalar";
+pthread_once_t tableKernelOnce = PTHREAD_ONCE_INIT;
+
+// picks a kernel by name -> false if this build or CPU can't run it
+bool pickTableKernel(const char *name){
+    bool automatic = strcmp(name, "auto") == 0;
+#if defined(__x86_64__) && !defined(ALLOCATOR_NO_SIMD)
+    if ((automatic || strcmp(name, "avx2") == 0) && __builtin_cpu_supports("avx2")) {
+        firstFitKernel = firstFitAvx2;
+        maxHoleKernel = maxHoleAvx2;
+        tableKernelName = "avx2";
+        return true;
+    }
+#elif defined(__aarch64__) && !defined(ALLOCATOR_NO_SIMD)
+    if (automatic || strcmp(name, "neon") == 0) { // every aarch64 CPU has NEON
+        firstFitKernel = firstFitNeon;
+        maxHoleKernel = maxHoleNeon;
+        tableKernelName = "neon";
+        return true;
+    }
+#endif
+    if (automatic || strcmp(name, "scalar") == 0) {
+        firstFitKernel = firstFitScalar;
+        maxHoleKernel = maxHoleScalar;
+        tableKernelName = "scalar";
+        return true;
+    }
+    return false;
+}
+
+void detectTableKernel(void){ pickTableKernel("auto"); }
+
+// switches every memory to another kernel -> NULL if it can't run here, meant for benchmarks between runs
+const char *useTableKernel(const char *name){
+    pthread_once(&tableKernelOnce, detectTableKernel);
+    return pickTableKernel(name) ? tableKernelName : NULL;
+}
+
+int firstFitSearch(const long *limits, const unsigned long long *holes, int count, long size, long *visited){
+    pthread_once(&tableKernelOnce, detectTableKernel);
+    return firstFitKernel(limits, holes, count, size, visited);
+}
+
+// worst-fit is the first-fit of the biggest hole -> lowest address among equal sizes like the size index
+int worstFitSearch(const long *limits, const unsigned long long *holes, int count, long *visited){
+    pthread_once(&tableKernelOnce, detectTableKernel);
+    long max = maxHoleKernel(limits, holes, count);
+    return max == 0 ? -1 : firstFitKernel(limits, holes, count, max, visited);
+}
+
+// lowest entry that is a hole with at least size bytes -> -1 if there is none
+int tableFirstFit(BlockTable *table, long size, long *visited){
+    return firstFitSearch(table->limits, table->holes, table->count, size, visited);
+}
+
+void tableDestroy(BlockTable *table){
+    free(table->bases);
+    free(table->limits);
+    free(table->nodes);
+    free(table->holes);
+}
+
+// *************************************************************************************
+
+
+
+// ************************************** PROFILE **************************************
+// counters and latency histograms of make PROFILE=1 builds -> every memory keeps its own, so threads never share them
+
+#ifdef ALLOCATOR_PROFILE
+
+#define PROFILE_BUCKETS 40  // bucket i counts latencies of [2^i, 2^(i+1)) nanoseconds
+#define PROFILE_COMMANDS 32 // dispatcher command names kept per memory -> later names count as "other"
+
+typedef enum { PROFILE_ALLOCATE, PROFILE_BATCH, PROFILE_DEALLOCATE, PROFILE_RESIZE, PROFILE_COMPACT, PROFILE_TIMERS } ProfileTimer;
+
+const char *PROFILE_TIMER_NAMES[PROFILE_TIMERS] = { "allocate", "allocate_batch", "deallocate", "resize", "compact" };
+
+typedef struct {
+    long count;
+    long totalNanoseconds;
+    long maxNanoseconds;
+    long buckets[PROFILE_BUCKETS];
+} LatencyHistogram;
+
+typedef struct {
+    char name[16]; // command word as typed, lowercase
+    LatencyHistogram latency;
+} CommandProfile;
+
+typedef struct {
+    long splits; // blocks cut off a hole or buddy block
+    long merges; // blocks merged into a neighbour and given back to the pool
+    LatencyHistogram timers[PROFILE_TIMERS]; // text API calls -> allocate, deallocate, compact, ...
+    CommandProfile commands[PROFILE_COMMANDS]; // dispatched commands of the interactive loop and scripts
+    int commandCount;
+} Profile;
+
+#define PROFILE_COUNT(memory, counter) ((memory)->profile.counter++)
+#define PROFILE_TIMER(memory, timer, clock) histogramAdd(&(memory)->profile.timers[timer], profileClock() - (clock))
+
+void histogramAdd(LatencyHistogram *histogram, long nanoseconds);
+
+#else
+
+#define PROFILE_COUNT(memory, counter)
+#define PROFILE_TIMER(memory, timer, clock)
+
+#endif
+
+// *************************************************************************************
+
+
+
+// *************************************** MEMORY **************************************
+// linked list structure for memory
+
+#define BUDDY_MAX_ORDER 63 // blocks are at most 2^62 bytes since sizes are long
+#define BUDDY_MIN_ORDER 4  // smallest block handed to a process is 16 bytes
+
+#define QUICK_BINS 64           // quick lists per memory -> direct mapped by size
+#define QUICK_MAX_SIZE 65536    // bigger blocks are always merged right away
+
+// LIFO stack of freed blocks of one exact size -> linked through freeNext
+typedef struct {
+    long size;  // limit of every block in the stack
+    Block *top;
+} QuickBin;
+
+typedef enum {
+    ENGINE_LIST,  // F, B and W -> holes are merged and live in holesBySize
+    ENGINE_BUDDY, // Y -> holes are buddy blocks and live in buddyFree
+    ENGINE_TLSF   // T -> holes are merged and live in tlsf
+} Engine;
+
+struct Memory {
+    Block *head;       // pointer to start of memory blocks -> head pointer of linked list
+    long total_memory; // size of the memory 
+    Treap holesBySize; // every hole ordered by (limit, base) -> used by best-fit and worst-fit
+    Treap blocksByAddress; // every block ordered by base -> used to seek into the map without walking from head
+    bool addressIndexed;   // blocksByAddress is built and kept up to date -> only after the first seek
+    PidTable processes; // every process block by PID -> used for duplicate checks and releases
+    bool compactOnFailure; // compact just enough and retry when RQ finds no hole
+    long compactions;      // number of compactions run
+    long compactedBytes;   // total bytes moved by compactions
+    long compactedBlocks;  // total process blocks moved by compactions
+    Engine engine;         // engine that owns the memory -> can only change while no process is allocated
+    Block *buddyFree[BUDDY_MAX_ORDER]; // free buddy blocks of size 2^order, one list per order
+    long internalFragmentation; // bytes handed out to processes beyond what they requested
+    Tlsf tlsf;             // segregated hole free lists of the TLSF engine
+    long freeBytes;        // bytes in holes -> kept up to date by indexHole and unindexHole
+    int holeCount;         // number of holes -> kept up to date by indexHole and unindexHole
+    BlockPool pool;        // nodes of this memory's blocks
+    long nodesVisited;     // blocks and free lists inspected while searching for holes -> tree lookups are counted by the tree
+    bool scripted_mode;    // keeps track if scripted mode is on or off -> affects printError
+    PidInterner names;     // ids of every PID seen so far -> ids are never recycled, HOLE_PID is HOLE_ID
+    BlockTable table;      // array copy of the block list -> only kept up to date while tableActive
+    bool useTable;         // SOA ON -> first-fit scans table instead of the list
+    QuickBin quick[QUICK_BINS]; // freed blocks waiting to be reused or merged -> list and TLSF engines only
+    bool useQuick;         // FAST ON -> releases park small blocks in quick lists and merging waits
+    long quickBlocks;      // blocks in quick lists
+    long quickBytes;       // bytes in quick lists -> free, but not in any hole index
+    long quickRequests;    // RQs made while FAST ON
+    long quickHits;        // RQs served straight from a quick list
+    long consolidations;   // times the quick lists were merged back into holes
+    long resizes;          // RS calls that succeeded
+    long resizesInPlace;   // resizes served from the block and its neighbouring holes -> no hole search
+    long resizeBytesMoved; // process bytes copied by resizes that moved the block
+    long longLived;        // processes placed with a LONG hint -> compaction is two sided while any is allocated
+    bool legacyBestFit;    // best-fit never picks a hole spanning the whole memory -> set by the text front end only
+#ifdef ALLOCATOR_PROFILE
+    Profile profile;       // counters and latency histograms of PROF
+#endif
+};
+
+// checks if the block table mirrors the list -> list engine only, buddy and TLSF never scan
+bool tableActive(Memory *memory){ return memory->useTable && memory->engine == ENGINE_LIST; }
+
+
+// orders holes by size, ties are broken by address so the lowest address wins like a list scan would
+int compareHoleSize(const TreapNode *a, const TreapNode *b){
+    const Block *blockA = blockFromSizeNode(a);
+    const Block *blockB = blockFromSizeNode(b);
+
+    if (blockA->limit != blockB->limit) return blockA->limit < blockB->limit ? -1 : 1;
+    if (blockA->base != blockB->base) return blockA->base < blockB->base ? -1 : 1;
+    return 0;
+}
+
+// orders blocks by start address -> blocks never overlap, so bases are unique
+int compareBlockBase(const TreapNode *a, const TreapNode *b){
+    const Block *blockA = blockFromAddressNode(a);
+    const Block *blockB = blockFromAddressNode(b);
+
+    if (blockA->base != blockB->base) return blockA->base < blockB->base ? -1 : 1;
+    return 0;
+}
+
+// keeps the address index in sync -> nothing to do until the first seek builds it
+void addressInsert(Memory *memory, Block *b){
+    if (memory->addressIndexed) treapInsert(&memory->blocksByAddress, &b->addressNode);
+}
+
+// call before the block is destroyed, its base must not have changed since addressInsert
+void addressRemove(Memory *memory, Block *b){
+    if (memory->addressIndexed) treapRemove(&memory->blocksByAddress, &b->addressNode);
+}
+
+// adds a hole to the hole index of the engine -> call after the hole's base and limit are final
+void indexHole(Memory *memory, Block *hole){
+    memory->freeBytes += hole->limit;
+    memory->holeCount++;
+    if (memory->engine == ENGINE_TLSF) tlsfInsert(&memory->tlsf, hole);
+    else treapInsert(&memory->holesBySize, &hole->sizeNode);
+}
+
+// removes a hole from the hole index of the engine -> call before changing the hole's base or limit
+void unindexHole(Memory *memory, Block *hole){
+    memory->freeBytes -= hole->limit;
+    memory->holeCount--;
+    if (memory->engine == ENGINE_TLSF) tlsfRemove(&memory->tlsf, hole);
+    else treapRemove(&memory->holesBySize, &hole->sizeNode);
+}
+
+// finds the smallest hole with at least size bytes -> lowest address among equal sizes
+Block *findBestFitHole(Memory *memory, long size){
+    Block probe = { .base = -1, .limit = size }; // base -1 is smaller than every real address
+
+    TreapNode *node = treapLowerBound(&memory->holesBySize, &probe.sizeNode);
+    return node == NULL ? NULL : blockFromSizeNode(node);
+}
+
+// finds the biggest hole with at least size bytes -> lowest address among equal sizes
+Block *findWorstFitHole(Memory *memory, long size){
+    TreapNode *node = treapMax(&memory->holesBySize);
+    if (node == NULL || blockFromSizeNode(node)->limit < size) return NULL;
+
+    return findBestFitHole(memory, blockFromSizeNode(node)->limit); // first hole with the maximum size
+}
+
+// memory constructor -> memory starts as one GIANT hole
+Memory *createMemory(long total_memory, bool scripted_mode){
+    Memory *memory = (Memory *) calloc(1, sizeof(Memory)); // fresh counters and empty engine structures
+    memory->total_memory = total_memory;
+    memory->scripted_mode = scripted_mode;
+    treapInit(&memory->holesBySize, compareHoleSize);
+    treapInit(&memory->blocksByAddress, compareBlockBase);
+    pidTableInit(&memory->processes, PID_TABLE_MIN_CAPACITY);
+    memory->engine = ENGINE_LIST;
+    internPID(&memory->names, HOLE_PID); // first id is HOLE_ID
+    memory->head = createBlock(&memory->pool, HOLE_PID, HOLE_ID, 0, total_memory);
+    indexHole(memory, memory->head);
+    return memory;
+}
+
+
+// memory destructor -> blocks live in the pool, so giving the pool's chunks back frees every block
+void destroyMemory(Memory *memory){
+    poolDestroy(&memory->pool);
+    free(memory->processes.slots);
+    freeInterner(&memory->names);
+    tableDestroy(&memory->table);
+    free(memory);
+}
+
+// bytes handed out to processes beyond what they requested -> only the buddy engine rounds sizes up
+long internalFragmentation(Memory *memory){ return memory->internalFragmentation; }
+
+// blocks and index nodes inspected while searching for holes -> used by the benchmark
+long nodesVisited(Memory *memory){ return memory->nodesVisited + memory->holesBySize.visited; }
+
+
+// function for checking that there are no processes with the same PID
+bool pidExists(Memory *memory, const char *PID){
+    // used for not allowing duplicate PID names
+    return pidTableFind(&memory->processes, PID) != NULL; // holes are never in the table
+} 
+
+// block that holds address -> O(log n) through the address index, NULL if address is outside memory
+// the index is built by the first call, workloads that never seek don't pay for keeping it up to date
+Block *blockAt(Memory *memory, long address){
+    if (address < 0 || address >= memory->total_memory) return NULL;
+
+    if (!memory->addressIndexed) {
+        memory->addressIndexed = true;
+        for (Block *b = memory->head; b != NULL; b = b->next) addressInsert(memory, b);
+    }
+
+    Block probe = { .base = address + 1 };
+    TreapNode *after = treapLowerBound(&memory->blocksByAddress, &probe.addressNode); // first block starting after address
+    if (after == NULL) return blockFromAddressNode(treapMax(&memory->blocksByAddress)); // address is in the last block
+    return blockFromAddressNode(after)->prev;
+}
+
+// *************************************************************************************
+
+
+
+
+// places a process at the start of a hole that has enough space -> LONG processes go to the end of the hole
+void placeProcess(Memory *memory, Block *hole, const char *PID, long size, bool longLived){
+    unsigned int pid = internPID(&memory->names, PID);
+    int slot = tableActive(memory) ? tableFind(&memory->table, hole->base) : -1; // hole's table entry
+    unindexHole(memory, hole); // hole's key is about to change
+    if (longLived) memory->longLived++;
+
+    if (hole->limit == size){ // size is equal, no fragmentation 
+        setBlockPID(hole, PID, pid); // just change name of hole block
+        hole->requested = size;
+        hole->longLived = longLived;
+        pidTableInsert(&memory->processes, hole);
+        if (slot >= 0) tableSet(&memory->table, slot, hole);
+        return;
+    }
+
+    if (longLived) { // carve the process from the high end, the hole keeps its base
+        Block *newProcess = createBlock(&memory->pool, PID, pid, hole->base + hole->limit - size, size);
+        PROFILE_COUNT(memory, splits);
+        newProcess->requested = size;
+        newProcess->longLived = true;
+
+        // insert new process block after hole block
+        newProcess->prev = hole;
+        newProcess->next = hole->next;
+        if (hole->next != NULL) hole->next->prev = newProcess;
+        hole->next = newProcess;
+        pidTableInsert(&memory->processes, newProcess);
+
+        hole->limit -= size;
+        indexHole(memory, hole); // put shrunk hole back to size index
+        addressInsert(memory, newProcess);
+
+        if (slot >= 0) {
+            tableSet(&memory->table, slot, hole);
+            tableInsert(&memory->table, slot + 1, newProcess);
+        }
+        return;
+    }
+
+    // limit > size
+    Block *newProcess = createBlock(&memory->pool, PID, pid, hole->base, size); // create memory block for new process
+    PROFILE_COUNT(memory, splits);
+    newProcess->requested = size;
+
+    // insert new process block before hole block
+    newProcess->prev = hole->prev;
+    newProcess->next = hole;
+    if (hole->prev == NULL) {
+        memory->head = newProcess; // inserting at head
+    } else {
+        hole->prev->next = newProcess; // inserting in middle
+    }
+    hole->prev = newProcess;
+    pidTableInsert(&memory->processes, newProcess);
+
+    // update hole block's base and limit 
+    hole->base += size;
+    hole->limit -= size;
+    indexHole(memory, hole); // put shrunk hole back to size index
+    addressInsert(memory, newProcess); // hole's base moved past newProcess first
+
+    if (slot >= 0) { // new process takes the hole's entry, hole moves one up
+        tableInsert(&memory->table, slot, newProcess);
+        tableSet(&memory->table, slot + 1, hole);
+    }
+}
+
+
+// finds the hole chosen by the strategy flag -> NULL if no hole is big enough
+// LONG processes take the last fitting hole with first-fit, the other strategies pick the same hole either way
+Block *findHole(Memory *memory, char flag, long size, bool longLived){
+    Block *target = NULL;
+
+    if (flag == 'f' && longLived) {
+        // First-fit from the high end -> the address index finds the last block without walking from head
+        for (Block *current = blockAt(memory, memory->total_memory - 1); current != NULL; current = current->prev) {
+            memory->nodesVisited++;
+            if (isHole(current) && hasEnoughSpace(current, size)) return current;
+        }
+
+    } else if (flag == 'f') {
+        // First-fit logic
+        if (tableActive(memory)) { // same hole as the list scan, found in the arrays
+            int slot = tableFirstFit(&memory->table, size, &memory->nodesVisited);
+            return slot < 0 ? NULL : memory->table.nodes[slot];
+        }
+
+        Block *current = memory->head; // current pointer to head
+
+        while (current != NULL) { // loop through linked list
+            memory->nodesVisited++;
+            if (isHole(current) && hasEnoughSpace(current, size) ){
+                target = current; // this block is allocatable
+                break;
+            }
+            
+            // update current pointer after each loop
+            current = current->next;
+        }
+
+    } else if (flag == 'b') {
+        // Best-fit logic -> lower bound lookup in the size index instead of scanning the whole list
+        target = findBestFitHole(memory, size);
+
+        // the original scan started with bestFitSize = total_memory and only accepted smaller holes,
+        // so a hole spanning the whole memory was never chosen -> kept for old scripts when legacyBestFit is on
+        if (memory->legacyBestFit && target != NULL && target->limit == memory->total_memory) target = NULL;
+
+    } else if (flag == 'w') {
+        // Worst-fit logic -> biggest hole of the size index
+        target = findWorstFitHole(memory, size);
+
+    } else {
+        // TLSF logic -> first hole of the smallest non-empty size class that fits, found with bitmaps
+        memory->nodesVisited++; // one free list head is inspected
+        target = tlsfFind(&memory->tlsf, size);
+    }
+
+    return target;
+}
+
+
+// turns a process or quick-listed block into a hole -> neighbours come from the list, so merging them is O(1)
+void coalesceBlock(Memory *memory, Block *current){
+    // deallocate current block by turning it to a hole
+    int slot = tableActive(memory) ? tableFind(&memory->table, current->base) : -1; // current's table entry
+    setBlockPID(current, HOLE_PID, HOLE_ID);
+
+    // if prev and next are holes, current will be merged into one large block with prev and next
+
+    // check if next block is hole -> for merging
+    if (current->next != NULL && isHole(current->next)){ // check if current is not last node AND next block is hole
+        Block *next = current->next; // get a pointer to next block
+        unindexHole(memory, next); // next block stops being a separate hole
+        current->limit += next->limit; // elongate current block's limit with next block's limit to merge
+        current->next = next->next; // update merged current block's next pointer to block after next block or NULL if next block was last node
+        
+        if (next->next != NULL){ // check if next block is not last node
+            next->next->prev = current; // update block after next block's prev pointer to point to merged current block
+        }
+        addressRemove(memory, next);
+        destroyBlock(&memory->pool, next); // dealloc memory block next points to -> remove next block since its already merged with current block
+        PROFILE_COUNT(memory, merges);
+        if (slot >= 0) tableRemove(&memory->table, slot + 1);
+    }
+
+
+    // check if previous block is hole -> for merging
+    if (current->prev != NULL && isHole(current->prev)){ // check if current is not head node AND next prev is hole
+        Block *previous = current->prev; // get a pointer to previous block
+        unindexHole(memory, previous); // previous block's limit is about to change
+        previous->limit += current->limit; // elongate previous block's limit with current block's limit to merge
+        previous->next = current->next; // update merged previous block's next pointer to block after current block
+        
+        if (current->next != NULL){ // check if current block is not last node
+            current->next->prev = previous; // update next block's prev pointer to point to merged (previous+current) block
+        }
+        addressRemove(memory, current);
+        destroyBlock(&memory->pool, current); // dealloc memory at current block -> remove current block since its already merged with previous block
+        PROFILE_COUNT(memory, merges);
+        indexHole(memory, previous); // put merged hole back to size index
+        if (slot >= 0) {
+            tableRemove(&memory->table, slot);
+            tableSet(&memory->table, slot - 1, previous);
+        }
+    }
+    else {
+        indexHole(memory, current); // current is the merged hole
+        if (slot >= 0) tableSet(&memory->table, slot, current);
+    }
+}
+
+
+
+// ************************************* QUICK LISTS ***********************************
+// deferred coalescing like dlmalloc fastbins -> a freed block keeps its place and size, so a request of
+// the same size takes it back in O(1); merging waits until an allocation fails, CONSOLIDATE or FAST OFF
+
+// quick list for blocks of size -> NULL if size is too big or the bin already holds another size
+QuickBin *quickBin(Memory *memory, long size){
+    if (size > QUICK_MAX_SIZE) return NULL;
+
+    QuickBin *bin = &memory->quick[((unsigned long) size * 0x9E3779B97F4A7C15UL) >> 58]; // top 6 bits -> QUICK_BINS
+    return bin->top == NULL || bin->size == size ? bin : NULL;
+}
+
+void quickPush(Memory *memory, QuickBin *bin, Block *b){
+    setBlockPID(b, HOLE_PID, FAST_ID); // shows up as free memory, but stays out of the hole index
+    b->requested = 0;
+    b->freeNext = bin->top;
+    bin->top = b;
+    bin->size = b->limit;
+    memory->quickBlocks++;
+    memory->quickBytes += b->limit;
+}
+
+Block *quickPop(Memory *memory, QuickBin *bin){
+    Block *b = bin->top;
+    bin->top = b->freeNext;
+    b->freeNext = NULL;
+    memory->quickBlocks--;
+    memory->quickBytes -= b->limit;
+    return b;
+}
+
+// hands a quick-listed block of exactly size bytes to a process -> false on a miss
+bool quickAllocate(Memory *memory, const char *PID, long size){
+    memory->quickRequests++;
+    QuickBin *bin = quickBin(memory, size);
+    if (bin == NULL || bin->top == NULL) return false;
+
+    Block *b = quickPop(memory, bin); // base, limit, address index and table entry stay as they are
+    setBlockPID(b, PID, internPID(&memory->names, PID));
+    b->requested = size;
+    pidTableInsert(&memory->processes, b);
+    memory->quickHits++;
+    return true;
+}
+
+// CONSOLIDATE -> every quick-listed block becomes a hole and merges with its neighbours
+void consolidate(Memory *memory){
+    if (memory->quickBlocks == 0) return;
+
+    for (int i = 0; i < QUICK_BINS; i++) {
+        while (memory->quick[i].top != NULL) coalesceBlock(memory, quickPop(memory, &memory->quick[i]));
+    }
+    memory->consolidations++;
+}
+
+// FAST ON|OFF -> turning it off merges what the quick lists still hold
+void setQuickLists(Memory *memory, bool enabled){
+    memory->useQuick = enabled;
+    if (!enabled) consolidate(memory);
+}
+
+// *************************************************************************************
+
+
+// *************************************** BUDDY ***************************************
+// binary buddy engine -> memory is split into power of two blocks, a block's buddy is found by flipping one address bit
+// every hole of the list is exactly one free buddy block, so adjacent holes are not merged like in the list engine
+
+// smallest order whose block fits size bytes
+int buddyOrder(long size){
+    int order = BUDDY_MIN_ORDER;
+    while (order < BUDDY_MAX_ORDER && (1L << order) < size) order++;
+    return order;
+}
+
+// order of a buddy block from its size
+int blockOrder(Block *b){
+    int order = 0;
+    while ((1L << order) < b->limit) order++;
+    return order;
+}
+
+void buddyPush(Memory *memory, Block *b, int order){
+    memory->freeBytes += b->limit;
+    memory->holeCount++;
+    b->freePrev = NULL;
+    b->freeNext = memory->buddyFree[order];
+    if (b->freeNext != NULL) b->freeNext->freePrev = b;
+    memory->buddyFree[order] = b;
+}
+
+void buddyUnlink(Memory *memory, Block *b, int order){
+    memory->freeBytes -= b->limit;
+    memory->holeCount--;
+    if (b->freePrev == NULL) memory->buddyFree[order] = b->freeNext; // b was first of the list
+    else b->freePrev->freeNext = b->freeNext;
+    if (b->freeNext != NULL) b->freeNext->freePrev = b->freePrev;
+}
+
+// removes every block and lays memory out again for the engine
+// buddy engine gets one hole per set bit of total_memory, other engines get one GIANT hole
+void resetMemory(Memory *memory, Engine engine){
+    Block *current = memory->head;
+    while (current != NULL) { // no process is allocated -> every block is a hole
+        Block *next = current->next;
+        if (memory->engine != ENGINE_BUDDY) unindexHole(memory, current);
+        destroyBlock(&memory->pool, current);
+        current = next;
+    }
+    for (int order = 0; order < BUDDY_MAX_ORDER; order++) memory->buddyFree[order] = NULL;
+    memory->blocksByAddress.root = NULL; // every block was destroyed
+    memory->freeBytes = 0; // buddy holes were dropped without unlinking
+    memory->holeCount = 0;
+
+    memory->engine = engine;
+    if (engine != ENGINE_BUDDY) { // one GIANT hole again
+        memory->head = createBlock(&memory->pool, HOLE_PID, HOLE_ID, 0, memory->total_memory);
+        addressInsert(memory, memory->head);
+        indexHole(memory, memory->head);
+        if (tableActive(memory)) tableRebuild(&memory->table, memory->head);
+        return;
+    }
+
+    // biggest blocks first so every block is aligned to its own size
+    long base = 0;
+    Block *last = NULL;
+    memory->head = NULL;
+    for (int order = BUDDY_MAX_ORDER - 1; order >= 0; order--) {
+        if ((memory->total_memory & (1L << order)) == 0) continue;
+
+        Block *block = createBlock(&memory->pool, HOLE_PID, HOLE_ID, base, 1L << order);
+        block->prev = last;
+        if (last == NULL) memory->head = block;
+        else last->next = block;
+        last = block;
+        addressInsert(memory, block);
+
+        buddyPush(memory, block, order);
+        base += 1L << order;
+    }
+}
+
+// switches memory to the engine of the requested strategy -> false if processes are still allocated
+bool selectEngine(Memory *memory, Engine engine){
+    if (memory->engine == engine) return true;
+    if (memory->processes.count > 0) return false; // blocks of the other engine are still in use
+
+    consolidate(memory); // resetMemory expects every block to be a hole
+    resetMemory(memory, engine);
+    return true;
+}
+
+// allocates a buddy block for a process -> O(log N) splits
+bool buddyAllocate(Memory *memory, const char *PID, long size){
+    int order = buddyOrder(size);
+    if (order >= BUDDY_MAX_ORDER) return false;
+
+    // find the smallest free block that fits
+    int found = order;
+    while (found < BUDDY_MAX_ORDER && memory->buddyFree[found] == NULL) {
+        memory->nodesVisited++;
+        found++;
+    }
+    if (found == BUDDY_MAX_ORDER) return false;
+
+    Block *block = memory->buddyFree[found];
+    buddyUnlink(memory, block, found);
+
+    // split block in halves until it has the wanted order, upper halves go back to free lists
+    while (found > order) {
+        found--;
+        block->limit = 1L << found;
+
+        Block *upper = createBlock(&memory->pool, HOLE_PID, HOLE_ID, block->base + block->limit, block->limit);
+        PROFILE_COUNT(memory, splits);
+        upper->prev = block; // insert upper half right after block
+        upper->next = block->next;
+        if (block->next != NULL) block->next->prev = upper;
+        block->next = upper;
+        addressInsert(memory, upper);
+
+        buddyPush(memory, upper, found);
+    }
+
+    setBlockPID(block, PID, internPID(&memory->names, PID));
+    block->requested = size;
+    memory->internalFragmentation += block->limit - size;
+    pidTableInsert(&memory->processes, block);
+    return true;
+}
+
+// turns a buddy block back to a hole and coalesces it with its free buddies -> O(log N) merges
+void buddyRelease(Memory *memory, Block *block){
+    memory->internalFragmentation -= block->limit - block->requested;
+    setBlockPID(block, HOLE_PID, HOLE_ID);
+
+    int order = blockOrder(block);
+    while (order + 1 < BUDDY_MAX_ORDER) {
+        long buddyBase = block->base ^ block->limit; // buddy address differs only in the bit of the block size
+        long parentBase = block->base & ~block->limit;
+        if (2 * block->limit > memory->total_memory - parentBase) break; // parent would leave memory -> no buddy
+
+        Block *buddy = buddyBase < block->base ? block->prev : block->next; // buddy is always a list neighbour
+        if (buddy == NULL || !isHole(buddy) || buddy->base != buddyBase || buddy->limit != block->limit) break; // buddy is split or in use
+
+        buddyUnlink(memory, buddy, order);
+        Block *lower = buddyBase < block->base ? buddy : block; // lower half survives as the parent
+        Block *upper = lower->next;
+        lower->limit *= 2;
+        lower->next = upper->next;
+        if (upper->next != NULL) upper->next->prev = lower;
+        addressRemove(memory, upper);
+        destroyBlock(&memory->pool, upper);
+        PROFILE_COUNT(memory, merges);
+
+        block = lower;
+        order++;
+    }
+
+    buddyPush(memory, block, order);
+}
+
+// *************************************************************************************
+
+
+// prints how much work a compaction did -> only in interactive mode like errors
+void reportCompaction(Memory *memory, long bytesMoved, int blocksMoved){
+    if (!memory->scripted_mode) {
+        printf("Compaction moved %ld bytes in %d blocks\n", bytesMoved, blocksMoved);
+    }
+}
+
+
+// slides process blocks to top in place and gathers holes into one gap that moves to bottom
+void compactDown(Memory *memory, long targetHole, long *bytesMoved, int *blocksMoved){
+    Block *gap = NULL; // hole that collects every hole seen so far -> always right before current
+    Block *current = memory->head; // current pointer to head
+
+    while (current != NULL) {
+        Block *next = current->next;
+
+        if (isHole(current)) {
+            unindexHole(memory, current); // hole changes while sliding, put back to size index at the end
+            addressRemove(memory, current); // sliding processes keep their order, only holes leave
+
+            if (gap == NULL) { // first hole becomes the gap
+                gap = current;
+            } else { // gap is right before current -> merge current into gap
+                gap->limit += current->limit;
+                gap->next = next;
+                if (next != NULL) next->prev = gap;
+                destroyBlock(&memory->pool, current);
+                PROFILE_COUNT(memory, merges);
+            }
+
+            if (targetHole > 0 && gap->limit >= targetHole) break; // partial compaction done
+        }
+        else if (gap != NULL) { // process after gap -> slide process up by swapping it with gap
+            current->base = gap->base; // rewrite base on existing node
+            gap->base += current->limit;
+            *bytesMoved += current->limit;
+            (*blocksMoved)++;
+
+            // relink as ... -> current -> gap -> next
+            current->prev = gap->prev;
+            if (gap->prev == NULL) memory->head = current;
+            else gap->prev->next = current;
+            current->next = gap;
+            gap->prev = current;
+            gap->next = next;
+            if (next != NULL) next->prev = gap;
+        }
+
+        current = next; // update current pointer
+    }
+
+    if (gap != NULL) {
+        indexHole(memory, gap); // gap is the merged hole
+        addressInsert(memory, gap);
+    }
+}
+
+// slides short-lived processes to top and LONG processes to bottom, every hole merges into one gap between them
+// blocks already packed against their end stay where they are, so long-lived blocks are not moved again and again
+// always compacts fully -> the gap is only known once every block was seen
+void compactTwoSided(Memory *memory, long *bytesMoved, int *blocksMoved){
+    Block *runs[3][2] = { { NULL, NULL }, { NULL, NULL }, { NULL, NULL } }; // first and last block of short, gap and long runs
+    long low = 0;       // end of the short-lived run
+    long longBytes = 0; // bytes of LONG processes
+
+    for (Block *current = memory->head, *next; current != NULL; current = next) {
+        next = current->next;
+
+        if (isHole(current)) {
+            unindexHole(memory, current);
+            addressRemove(memory, current); // address order changes, gap is put back at the end
+            if (runs[1][0] == NULL) runs[1][0] = runs[1][1] = current; // first hole becomes the gap
+            else {
+                runs[1][0]->limit += current->limit;
+                destroyBlock(&memory->pool, current);
+                PROFILE_COUNT(memory, merges);
+            }
+            continue;
+        }
+
+        int run = current->longLived ? 2 : 0;
+        if (run == 0) { // short-lived process -> packed against the low end in list order
+            if (current->base != low) {
+                current->base = low;
+                *bytesMoved += current->limit;
+                (*blocksMoved)++;
+            }
+            low += current->limit;
+        }
+        else longBytes += current->limit;
+
+        current->prev = runs[run][1]; // append current to its run
+        if (runs[run][1] == NULL) runs[run][0] = current;
+        else runs[run][1]->next = current;
+        runs[run][1] = current;
+    }
+
+    long high = memory->total_memory - longBytes; // LONG processes are packed against the high end in list order
+    for (Block *current = runs[2][0]; current != NULL; current = current == runs[2][1] ? NULL : current->next) {
+        if (current->base != high) {
+            current->base = high;
+            *bytesMoved += current->limit;
+            (*blocksMoved)++;
+        }
+        high += current->limit;
+    }
+
+    // relink as short run -> gap -> long run
+    Block *last = NULL;
+    for (int run = 0; run < 3; run++) {
+        if (runs[run][0] == NULL) continue;
+        runs[run][0]->prev = last;
+        if (last == NULL) memory->head = runs[run][0];
+        else last->next = runs[run][0];
+        last = runs[run][1];
+    }
+    last->next = NULL;
+
+    Block *gap = runs[1][0];
+    if (gap != NULL) {
+        gap->base = low;
+        indexHole(memory, gap); // gap is the merged hole
+    }
+
+    if (memory->addressIndexed) { // a LONG process can end up after a short one that was above it
+        memory->blocksByAddress.root = NULL;
+        for (Block *b = memory->head; b != NULL; b = b->next) addressInsert(memory, b);
+    }
+}
+
+// compacts list and TLSF memory -> two sided while LONG processes are allocated
+// bytesMoved and blocksMoved get the process memory and blocks that changed address
+AllocSimResult compactBlocks(Memory *memory, long targetHole, long *bytesMoved, int *blocksMoved){
+    if (memory->engine == ENGINE_BUDDY) return ALLOCSIM_ERR_UNSUPPORTED; // moving a buddy block breaks its alignment
+    consolidate(memory); // quick-listed blocks are free, they must not slide like processes
+
+    // partial compaction has nothing to do if a big enough hole already exists
+    if (targetHole > 0 && (memory->engine == ENGINE_TLSF ? tlsfFind(&memory->tlsf, targetHole) : findBestFitHole(memory, targetHole)) != NULL) {
+        return ALLOCSIM_OK;
+    }
+
+    if (memory->longLived > 0) compactTwoSided(memory, bytesMoved, blocksMoved);
+    else compactDown(memory, targetHole, bytesMoved, blocksMoved);
+
+    if (tableActive(memory)) tableRebuild(&memory->table, memory->head); // every base after the first hole changed
+
+    memory->compactions++;
+    memory->compactedBytes += *bytesMoved;
+    memory->compactedBlocks += *blocksMoved;
+    return ALLOCSIM_OK;
+}
+
+// prints the message of a failed API call the way the text commands always did
+void printResult(Memory *memory, AllocSimResult result){
+    char error[128];
+    snprintf(error, sizeof(error), "ERROR: %s", allocsim_strerror(result));
+    printError(memory, error);
+}
+
+// engine that serves a strategy flag
+Engine flagEngine(char flag){ return flag == 'y' ? ENGINE_BUDDY : flag == 't' ? ENGINE_TLSF : ENGINE_LIST; }
+
+// searches again after findHole found nothing -> merges the quick lists first, then compacts if AUTOC is on
+Block *findHoleAfterMiss(Memory *memory, char flag, long size, bool longLived){
+    Block *target = NULL;
+
+    if (memory->quickBlocks > 0) { // deferred merging happens when an allocation fails
+        consolidate(memory);
+        target = findHole(memory, flag, size, longLived);
+    }
+
+    if (target == NULL && memory->compactOnFailure) { // compact just enough for the request and try again
+        long bytesMoved = 0;
+        int blocksMoved = 0;
+        compactBlocks(memory, size, &bytesMoved, &blocksMoved);
+        reportCompaction(memory, bytesMoved, blocksMoved);
+        target = findHole(memory, flag, size, longLived);
+    }
+    return target;
+}
+
+// places a checked request with the strategy of flag -> false if nothing fits, even after merging quick lists and AUTOC
+// buddy blocks have fixed places, so the LONG hint only matters for the list and TLSF engines
+bool placeRequest(Memory *memory, char flag, const char *PID, long size, bool longLived){
+    if (flag == 'y') return buddyAllocate(memory, PID, size); // Buddy system logic
+    if (memory->useQuick && !longLived && quickAllocate(memory, PID, size)) return true; // quick-listed blocks sit among short-lived ones
+
+    Block *target = findHole(memory, flag, size, longLived);
+    if (target == NULL) target = findHoleAfterMiss(memory, flag, size, longLived);
+    if (target == NULL) return false;
+
+    placeProcess(memory, target, PID, size, longLived);
+    return true;
+}
+
+// checks the PID and size of a request against memory
+AllocSimResult checkRequest(Memory *memory, const char *PID, long size){
+    if (PID == NULL || PID[0] == '\0' || strlen(PID) > ALLOCSIM_PID_MAX || strcmp(PID, HOLE_PID) == 0) {
+        return ALLOCSIM_ERR_INVALID_PID; // blocks hold at most ALLOCSIM_PID_MAX characters and HOLE_PID marks holes
+    }
+
+    if (pidExists(memory, PID)){ // check if there is already a process with given PID
+        return ALLOCSIM_ERR_PID_EXISTS; // we can't allow PID duplicates because it would corrupt allocation logic
+    }
+
+    if (size <= 0) return ALLOCSIM_ERR_INVALID_SIZE;
+    return ALLOCSIM_OK;
+}
+
+// RQ without printing -> address gets the base of the new process block
+AllocSimResult allocsim_request(AllocSim *memory, const char *PID, long size, char strategy, long *address){
+    return allocsim_request_hint(memory, PID, size, strategy, ALLOCSIM_LIFETIME_SHORT, address);
+}
+
+// RQ with a lifetime hint -> LONG processes are placed from the high end of memory, away from short-lived ones
+AllocSimResult allocsim_request_hint(AllocSim *memory, const char *PID, long size, char strategy, AllocSimLifetime lifetime, long *address){
+    AllocSimResult result = checkRequest(memory, PID, size); // argument validation
+    if (result != ALLOCSIM_OK) return result;
+
+    char flag = tolower(strategy); // make strategy flag case-insensitive
+    if (flag != 'f' && flag != 'b' && flag != 'w' && flag != 'y' && flag != 't') return ALLOCSIM_ERR_INVALID_STRATEGY;
+    if (lifetime != ALLOCSIM_LIFETIME_SHORT && lifetime != ALLOCSIM_LIFETIME_LONG) return ALLOCSIM_ERR_INVALID_LIFETIME;
+
+    // every argument is checked -> selecting the engine is the first change to memory
+    if (!selectEngine(memory, flagEngine(flag))) return ALLOCSIM_ERR_ENGINE_BUSY; // blocks of different engines can't share memory
+    if (!placeRequest(memory, flag, PID, size, lifetime == ALLOCSIM_LIFETIME_LONG)) return ALLOCSIM_ERR_NO_MEMORY;
+
+    if (address != NULL) *address = pidTableFind(&memory->processes, PID)->base;
+    return ALLOCSIM_OK;
+}
+
+bool allocate(Memory *memory, char* PID, long size, char *type){
+
+/* TODO*/
+
+/*
+allocates memory from a hole to a process based on the algorithm chosen.
+Type = 'F' or 'f' for first fit, 'B' or 'b' for best fit, 'W' or 'w' for worst fit, 'Y' or 'y' for buddy system,
+'T' or 't' for two level segregated fit.
+*/
+    return allocateHinted(memory, PID, size, type, false);
+}
+
+// RQ with a lifetime hint -> LONG processes are placed from the high end of memory
+bool allocateHinted(Memory *memory, char* PID, long size, char *type, bool longLived){
+    PROFILE_START(started);
+    AllocSimLifetime lifetime = longLived ? ALLOCSIM_LIFETIME_LONG : ALLOCSIM_LIFETIME_SHORT;
+    AllocSimResult result = allocsim_request_hint(memory, PID, size, type[0], lifetime, NULL);
+    PROFILE_TIMER(memory, PROFILE_ALLOCATE, started);
+    if (result != ALLOCSIM_OK) printResult(memory, result);
+    return result == ALLOCSIM_OK;
+}
+
+
+// ************************************** BATCHES **************************************
+// RQB -> a burst of requests is checked against one lookup structure and placed together
+// first-fit walks the list once for the whole batch, the other strategies already find holes through an index
+
+// requests of a batch that still wait for a hole, in batch order
+typedef struct {
+    long *next; // index of the next pending request, -1 ends the list
+    long first; // first pending request, -1 if every request is placed
+} PendingList;
+
+// first-fit for every pending request in one walk over the list -> each hole is offered to the pending requests in
+// batch order, which is the hole sequential RQs would pick since placing never grows a hole that was passed
+void firstFitBatch(Memory *memory, AllocSimRequest *requests, PendingList *pending){
+    long smallest = LONG_MAX; // no pending request is smaller -> holes below it are passed without looking at requests
+    for (long i = pending->first; i >= 0; i = pending->next[i]) {
+        if (requests[i].size < smallest) smallest = requests[i].size;
+    }
+
+    Block *current = memory->head;
+    while (current != NULL && pending->first >= 0) {
+        memory->nodesVisited++;
+        Block *next = current->next; // placing inserts the process before current, so the walk goes on after it
+        if (!isHole(current) || current->limit < smallest) {
+            current = next;
+            continue;
+        }
+
+        long *link = &pending->first; // offer the hole to every pending request, recomputing the smallest left
+        smallest = LONG_MAX;
+        while (*link >= 0) {
+            long i = *link;
+            if (isHole(current) && requests[i].size <= current->limit) {
+                placeProcess(memory, current, requests[i].PID, requests[i].size, false); // an exact fit turns current into the process
+                requests[i].result = ALLOCSIM_OK;
+                *link = pending->next[i];
+            } else {
+                if (requests[i].size < smallest) smallest = requests[i].size;
+                link = &pending->next[i];
+            }
+        }
+        current = next;
+    }
+}
+
+// RQB without printing -> results and addresses are written into requests, returns the number of requests placed
+// requests the coordinated pass can't place are retried one by one after it, where quick list merging and AUTOC
+// compaction happen like for RQ; a repeated PID waits for the end of the batch and fails like an RQ of an allocated PID
+// only if an earlier request of it was placed
+long allocsim_request_batch(AllocSim *memory, AllocSimRequest *requests, long count, char strategy){
+    PidInterner names; // PIDs of this batch -> a repeated PID gets no new id
+    memset(&names, 0, sizeof(names));
+    PendingList pending = { (long *) malloc(sizeof(long) * (count + 1)), -1 };
+    PendingList repeats = { pending.next, -1 }; // a request is in one of the lists at most, so they share next
+    long *tail = &pending.first;
+    long *repeatTail = &repeats.first;
+
+    for (long i = 0; i < count; i++) {
+        requests[i].address = -1;
+        requests[i].result = checkRequest(memory, requests[i].PID, requests[i].size);
+        if (requests[i].result != ALLOCSIM_OK) continue;
+
+        unsigned int known = names.count;
+        internPID(&names, requests[i].PID);
+        if (names.count == known) {
+            requests[i].result = ALLOCSIM_ERR_PID_EXISTS; // unless every earlier request of the PID failed
+            *repeatTail = i;
+            repeatTail = &repeats.next[i];
+            continue;
+        }
+        requests[i].result = ALLOCSIM_ERR_NO_MEMORY; // until a hole is found
+        *tail = i;
+        tail = &pending.next[i];
+    }
+    *tail = -1;
+    *repeatTail = -1;
+    freeInterner(&names);
+
+    char flag = tolower(strategy); // make strategy flag case-insensitive
+    AllocSimResult batchResult = ALLOCSIM_OK;
+    if (flag != 'f' && flag != 'b' && flag != 'w' && flag != 'y' && flag != 't') batchResult = ALLOCSIM_ERR_INVALID_STRATEGY;
+    else if (pending.first >= 0 && !selectEngine(memory, flagEngine(flag))) batchResult = ALLOCSIM_ERR_ENGINE_BUSY;
+
+    long *link = &pending.first;
+    while (*link >= 0) { // quick lists and the indexed strategies place each request straight away
+        long i = *link;
+        if (batchResult != ALLOCSIM_OK) requests[i].result = batchResult;
+        else if (flag == 'y' && buddyAllocate(memory, requests[i].PID, requests[i].size)) requests[i].result = ALLOCSIM_OK;
+        else if (flag != 'y' && memory->useQuick && quickAllocate(memory, requests[i].PID, requests[i].size)) requests[i].result = ALLOCSIM_OK;
+        else if (flag != 'f' && flag != 'y') {
+            Block *target = findHole(memory, flag, requests[i].size, false);
+            if (target != NULL) {
+                placeProcess(memory, target, requests[i].PID, requests[i].size, false);
+                requests[i].result = ALLOCSIM_OK;
+            }
+        }
+
+        if (requests[i].result == ALLOCSIM_ERR_NO_MEMORY && flag != 'y') link = &pending.next[i]; // still waiting
+        else *link = pending.next[i];
+    }
+
+    if (flag == 'f') firstFitBatch(memory, requests, &pending);
+
+    for (long i = pending.first; i >= 0; i = pending.next[i]) {
+        Block *target = findHoleAfterMiss(memory, flag, requests[i].size, false);
+        if (target == NULL) continue;
+        placeProcess(memory, target, requests[i].PID, requests[i].size, false);
+        requests[i].result = ALLOCSIM_OK;
+    }
+
+    for (long i = repeats.first; i >= 0; i = repeats.next[i]) { // the RQs that would follow in a sequential series
+        if (pidExists(memory, requests[i].PID)) continue;
+        if (batchResult != ALLOCSIM_OK) requests[i].result = batchResult;
+        else if (placeRequest(memory, flag, requests[i].PID, requests[i].size, false)) requests[i].result = ALLOCSIM_OK;
+        else requests[i].result = ALLOCSIM_ERR_NO_MEMORY;
+    }
+    free(pending.next);
+
+    long placed = 0;
+    for (long i = 0; i < count; i++) { // compaction may have moved blocks placed earlier, so addresses are read last
+        if (requests[i].result != ALLOCSIM_OK) continue;
+        requests[i].address = pidTableFind(&memory->processes, requests[i].PID)->base;
+        placed++;
+    }
+    return placed;
+}
+
+// RQB -> every failed request is printed with its PID, returns the number of requests placed
+long allocateBatch(Memory *memory, char **PIDs, long *sizes, long count, char *type){
+    AllocSimRequest *requests = (AllocSimRequest *) malloc(sizeof(AllocSimRequest) * (count + 1));
+    for (long i = 0; i < count; i++) {
+        requests[i].PID = PIDs[i];
+        requests[i].size = sizes[i];
+    }
+
+    PROFILE_START(started);
+    long placed = allocsim_request_batch(memory, requests, count, type[0]);
+    PROFILE_TIMER(memory, PROFILE_BATCH, started);
+    for (long i = 0; i < count; i++) {
+        if (requests[i].result == ALLOCSIM_OK) continue;
+        char error[160];
+        snprintf(error, sizeof(error), "ERROR: %.20s: %s", PIDs[i], allocsim_strerror(requests[i].result));
+        printError(memory, error);
+    }
+    if (!memory->scripted_mode) printf("Placed %ld of %ld requests\n", placed, count);
+    free(requests);
+    return placed;
+}
+
+// *************************************************************************************
+
+
+// turns a block that left the pid table into a hole, or parks it in its quick list while FAST ON
+void freeBlock(Memory *memory, Block *current){
+    if (current->longLived) {
+        memory->longLived--;
+        current->longLived = false;
+    }
+
+    if (memory->engine == ENGINE_BUDDY) { // buddy blocks coalesce with their buddies only
+        buddyRelease(memory, current);
+        return;
+    }
+
+    QuickBin *bin = memory->useQuick ? quickBin(memory, current->limit) : NULL;
+    if (bin != NULL) { // merging waits until an allocation fails or CONSOLIDATE
+        quickPush(memory, bin, current);
+        return;
+    }
+
+    coalesceBlock(memory, current);
+}
+
+void releaseBlock(Memory *memory, Block *current){
+    pidTableRemove(&memory->processes, current->PID);
+    freeBlock(memory, current);
+}
+
+// RL without printing -> the freed block is merged with neighbouring holes
+AllocSimResult allocsim_release(AllocSim *memory, const char *PID){
+    // argument validation
+    if (PID == NULL || PID[0] == '\0' || strcmp(PID, HOLE_PID) == 0) return ALLOCSIM_ERR_INVALID_PID;
+
+    Block *current = pidTableFind(&memory->processes, PID); // find the block with given PID
+    if (current == NULL) return ALLOCSIM_ERR_PID_NOT_FOUND; // PID was not found
+    releaseBlock(memory, current);
+    return ALLOCSIM_OK;
+}
+
+// RL @address without printing -> address must be where a process block starts, like free() of a pointer
+AllocSimResult allocsim_release_at(AllocSim *memory, long address){
+    Block *current = blockAt(memory, address); // O(log n) through the address index
+    if (current == NULL) return ALLOCSIM_ERR_INVALID_ADDRESS;
+    if (isHole(current) || isFast(current) || current->base != address) return ALLOCSIM_ERR_NO_PROCESS_AT;
+    releaseBlock(memory, current);
+    return ALLOCSIM_OK;
+}
+
+
+
+bool deallocate(Memory *memory, char* PID){
+
+/* TODO*/
+
+/*
+Deallocates memory from a process to a hole.
+If the hole is adjacent to another hole, the two holes should be merged.
+*/
+    if (strcmp(PID, HOLE_PID) == 0) {
+        printError(memory, "ERROR: Can not deallocate a hole.");
+        return false;
+    }
+
+    PROFILE_START(started);
+    AllocSimResult result = allocsim_release(memory, PID);
+    PROFILE_TIMER(memory, PROFILE_DEALLOCATE, started);
+    if (result != ALLOCSIM_OK) printResult(memory, result);
+    return result == ALLOCSIM_OK;
+}
+
+// RL @address
+bool deallocateAt(Memory *memory, long address){
+    PROFILE_START(started);
+    AllocSimResult result = allocsim_release_at(memory, address);
+    PROFILE_TIMER(memory, PROFILE_DEALLOCATE, started);
+    if (result != ALLOCSIM_OK) printResult(memory, result);
+    return result == ALLOCSIM_OK;
+}
+
+
+
+// *************************************** RESIZE **************************************
+// RS -> a process grows into the hole after it, slides down into the hole before it, or gives its tail back as a hole
+// only when its neighbours are too small it is moved like realloc would, through the normal hole search
+
+// gives the last bytes of a list or TLSF block back -> they join the next hole or become a new one
+void shrinkBlock(Memory *memory, Block *b, long size){
+    int slot = tableActive(memory) ? tableFind(&memory->table, b->base) : -1; // b's table entry
+    Block *next = b->next;
+    long freed = b->limit - size;
+    b->limit = size;
+
+    if (next != NULL && isHole(next)) { // next hole starts earlier, its address order doesn't change
+        unindexHole(memory, next);
+        next->base -= freed;
+        next->limit += freed;
+        indexHole(memory, next);
+        if (slot >= 0) {
+            tableSet(&memory->table, slot, b);
+            tableSet(&memory->table, slot + 1, next);
+        }
+        return;
+    }
+
+    Block *hole = createBlock(&memory->pool, HOLE_PID, HOLE_ID, b->base + size, freed); // insert new hole right after b
+    PROFILE_COUNT(memory, splits);
+    hole->prev = b;
+    hole->next = next;
+    if (next != NULL) next->prev = hole;
+    b->next = hole;
+    addressInsert(memory, hole);
+    indexHole(memory, hole);
+    if (slot >= 0) {
+        tableSet(&memory->table, slot, b);
+        tableInsert(&memory->table, slot + 1, hole);
+    }
+}
+
+// grows a list or TLSF block to size bytes out of the hole right after it -> the hole must be big enough
+void growIntoNext(Memory *memory, Block *b, long size){
+    int slot = tableActive(memory) ? tableFind(&memory->table, b->base) : -1; // b's table entry
+    Block *next = b->next;
+    long needed = size - b->limit;
+    unindexHole(memory, next); // next's key is about to change
+    b->limit = size;
+
+    if (next->limit == needed) { // hole is used up
+        b->next = next->next;
+        if (next->next != NULL) next->next->prev = b;
+        addressRemove(memory, next);
+        destroyBlock(&memory->pool, next);
+        PROFILE_COUNT(memory, merges);
+        if (slot >= 0) {
+            tableRemove(&memory->table, slot + 1);
+            tableSet(&memory->table, slot, b);
+        }
+        return;
+    }
+
+    next->base += needed;
+    next->limit -= needed;
+    indexHole(memory, next);
+    if (slot >= 0) {
+        tableSet(&memory->table, slot, b);
+        tableSet(&memory->table, slot + 1, next);
+    }
+}
+
+// slides a list or TLSF block down over the hole right before it -> the block keeps its end address
+void absorbPrevious(Memory *memory, Block *b){
+    int slot = tableActive(memory) ? tableFind(&memory->table, b->base) : -1; // b's table entry
+    Block *previous = b->prev;
+    unindexHole(memory, previous);
+    addressRemove(memory, previous); // b takes previous' base, address order stays the same once previous is gone
+
+    b->base = previous->base;
+    b->limit += previous->limit;
+    b->prev = previous->prev;
+    if (previous->prev == NULL) memory->head = b;
+    else previous->prev->next = b;
+    destroyBlock(&memory->pool, previous);
+    PROFILE_COUNT(memory, merges);
+
+    if (slot >= 0) {
+        tableRemove(&memory->table, slot - 1);
+        tableSet(&memory->table, slot - 1, b);
+    }
+}
+
+// resizes a list or TLSF block without a hole search -> false if the holes around it are too small
+bool resizeInPlace(Memory *memory, Block *b, long size){
+    long after = b->next != NULL && isHole(b->next) ? b->next->limit : 0;   // bytes b can grow by and keep its address
+    long before = b->prev != NULL && isHole(b->prev) ? b->prev->limit : 0;  // bytes b can grow by if it slides down
+    if (size > b->limit + after + before) return false;
+
+    if (size > b->limit + after) { // process data is copied down to the start of the previous hole
+        memory->resizeBytesMoved += b->requested;
+        absorbPrevious(memory, b);
+    }
+
+    if (size > b->limit) growIntoNext(memory, b, size);
+    else if (size < b->limit) shrinkBlock(memory, b, size);
+    b->requested = size;
+    return true;
+}
+
+// resizes a buddy block without a hole search -> shrinking frees upper halves, growing takes free upper buddies
+// false if b is not the lower half of every bigger block up to the new order or one of those buddies is in use
+bool buddyResizeInPlace(Memory *memory, Block *b, long size){
+    int order = blockOrder(b);
+    int wanted = buddyOrder(size);
+    if (wanted >= BUDDY_MAX_ORDER) return false;
+
+    Block *buddy = b->next; // upper buddies of b follow b in the list, smallest first
+    for (int check = order; check < wanted; check++, buddy = buddy->next) {
+        if ((b->base & (1L << check)) != 0 || buddy == NULL || !isHole(buddy) ||
+            buddy->base != b->base + (1L << check) || buddy->limit != 1L << check) return false;
+    }
+
+    memory->internalFragmentation -= b->limit - b->requested;
+
+    for (; order < wanted; order++) { // merge b with its free upper buddy one order at a time
+        buddy = b->next;
+        buddyUnlink(memory, buddy, order);
+        b->limit *= 2;
+        b->next = buddy->next;
+        if (buddy->next != NULL) buddy->next->prev = b;
+        addressRemove(memory, buddy);
+        destroyBlock(&memory->pool, buddy);
+        PROFILE_COUNT(memory, merges);
+    }
+
+    while (order > wanted) { // upper half goes back to the free lists -> its buddy is b, so it can't merge
+        order--;
+        b->limit = 1L << order;
+
+        Block *upper = createBlock(&memory->pool, HOLE_PID, HOLE_ID, b->base + b->limit, b->limit);
+        PROFILE_COUNT(memory, splits);
+        upper->prev = b; // insert upper half right after b
+        upper->next = b->next;
+        if (b->next != NULL) b->next->prev = upper;
+        b->next = upper;
+        addressInsert(memory, upper);
+
+        buddyPush(memory, upper, order);
+    }
+
+    b->requested = size;
+    memory->internalFragmentation += b->limit - size;
+    return true;
+}
+
+// RS without printing -> address gets the new base of the process block
+// strategy picks the hole if the block has to move, 0 uses F, Y or T depending on the engine in use
+AllocSimResult allocsim_resize(AllocSim *memory, const char *PID, long size, char strategy, long *address){
+    // argument validation
+    if (PID == NULL || PID[0] == '\0' || strcmp(PID, HOLE_PID) == 0) return ALLOCSIM_ERR_INVALID_PID;
+
+    Block *current = pidTableFind(&memory->processes, PID);
+    if (current == NULL) return ALLOCSIM_ERR_PID_NOT_FOUND;
+
+    if (size <= 0) return ALLOCSIM_ERR_INVALID_SIZE;
+
+    char flag = strategy != 0 ? tolower(strategy) : memory->engine == ENGINE_BUDDY ? 'y' : memory->engine == ENGINE_TLSF ? 't' : 'f';
+    if (flag != 'f' && flag != 'b' && flag != 'w' && flag != 'y' && flag != 't') return ALLOCSIM_ERR_INVALID_STRATEGY;
+    if (flagEngine(flag) != memory->engine) return ALLOCSIM_ERR_ENGINE_BUSY; // current is still allocated
+
+    bool inPlace = memory->engine == ENGINE_BUDDY ? buddyResizeInPlace(memory, current, size) : resizeInPlace(memory, current, size);
+    if (inPlace) {
+        memory->resizesInPlace++;
+    } else {
+        // current stays allocated until the new block is placed, so a failed move leaves memory as it was
+        pidTableRemove(&memory->processes, current->PID);
+        if (!placeRequest(memory, flag, PID, size, current->longLived)) { // the move keeps the lifetime hint
+            pidTableInsert(&memory->processes, current);
+            return ALLOCSIM_ERR_NO_MEMORY;
+        }
+        memory->resizeBytesMoved += current->requested < size ? current->requested : size;
+        freeBlock(memory, current);
+    }
+
+    memory->resizes++;
+    if (address != NULL) *address = pidTableFind(&memory->processes, PID)->base;
+    return ALLOCSIM_OK;
+}
+
+// RS -> type NULL moves the block with the default strategy of the engine
+bool reallocate(Memory *memory, char *PID, long size, char *type){
+    PROFILE_START(started);
+    AllocSimResult result = allocsim_resize(memory, PID, size, type != NULL ? type[0] : 0, NULL);
+    PROFILE_TIMER(memory, PROFILE_RESIZE, started);
+    if (result != ALLOCSIM_OK) printResult(memory, result);
+    return result == ALLOCSIM_OK;
+}
+
+// *************************************************************************************
+
+
+void status(Memory *memory){
+
+/* TODO*/
+
+/*
+Print the status of the memory manager.
+Includes each hole / process address, the amount of free memory, and the amount of allocated memory; ordered by starting memory address.
+
+Addresses [0:315000] Process P1
+Addresses [315001: 512500] Process P3
+Addresses [512501:625575] Unused
+Addresses [625575:725100] Process P6
+Addresses [725001] . . .
+
+*/
+
+    statusRange(memory, 0, memory->total_memory - 1);
+}
+
+
+// visits every block that overlaps [start:end] -> seeks to start through the address index instead of walking from head
+long allocsim_walk(AllocSim *memory, long start, long end, AllocSimVisitor visit, void *context){
+    long visited = 0;
+
+    Block *current = start <= 0 ? memory->head : blockAt(memory, start); // whole map STAT doesn't need the index
+    while (current != NULL && current->prev != NULL && isFree(current) && isFree(current->prev)) {
+        current = current->prev; // start of a free run, so it is visited as one hole
+    }
+
+    while (current != NULL && current->base <= end){
+        AllocSimBlock block = { isFree(current) ? NULL : current->PID, current->base, current->limit, isFree(current) ? 0 : current->requested };
+        current = current->next; // update current pointer
+
+        if (block.PID == NULL) {
+            // buddy holes and quick-listed blocks are not merged -> visit them as one hole like the list engine would
+            for (; current != NULL && isFree(current); current = current->next) block.limit += current->limit;
+        }
+
+        visited++;
+        if (visit(&block, context)) break;
+    }
+
+    return visited;
+}
+
+int printVisitor(const AllocSimBlock *block, void *buffer){
+    printBlock((StatBuffer *) buffer, block); // custom print function for blocks
+    return 0;
+}
+
+// prints every block that overlaps [start:end]
+void statusRange(Memory *memory, long start, long end){
+    StatBuffer buffer;
+    buffer.used = 0;
+
+    allocsim_walk(memory, start, end, printVisitor, &buffer);
+    statFlush(&buffer);
+}
+
+// WHO -> prints the block that holds address like STAT would
+void whoOwns(Memory *memory, long address){
+    if (address < 0 || address >= memory->total_memory) printResult(memory, ALLOCSIM_ERR_INVALID_ADDRESS);
+    else statusRange(memory, address, address);
+}
+
+
+
+// size of the biggest hole, taken from the hole index of the engine instead of walking the list
+long largestHole(Memory *memory){
+    if (memory->engine == ENGINE_BUDDY) { // highest order with a free block
+        for (int order = BUDDY_MAX_ORDER - 1; order >= 0; order--) {
+            if (memory->buddyFree[order] != NULL) return 1L << order;
+        }
+        return 0;
+    }
+
+    if (memory->engine == ENGINE_TLSF) return tlsfLargest(&memory->tlsf); // kept up to date by tlsfInsert and tlsfRemove
+
+    TreapNode *node = treapMax(&memory->holesBySize);
+    return node == NULL ? 0 : blockFromSizeNode(node)->limit;
+}
+
+
+// one line of aggregates from the running counters -> same cost for any number of blocks
+void statusSummary(Memory *memory){
+    long freeBytes = memory->freeBytes + memory->quickBytes;
+    printf("Addresses [0:%ld] %ld processes, %d holes, %ld bytes allocated, %ld bytes free, largest hole %ld bytes\n",
+           memory->total_memory - 1, (long) memory->processes.count, memory->holeCount,
+           memory->total_memory - freeBytes, freeBytes, largestHole(memory));
+}
+
+
+void printStats(Memory *memory){
+
+/*
+Prints memory occupancy and fragmentation from running counters -> no walk over the block list.
+*/
+    long largest = largestHole(memory);
+    long freeBytes = memory->freeBytes + memory->quickBytes; // quick-listed blocks are free too
+    double external = freeBytes > 0 ? 100.0 * (freeBytes - largest) / freeBytes : 0.0;
+
+    printf("Memory: %ld bytes, %ld allocated, %ld free\n", memory->total_memory, memory->total_memory - freeBytes, freeBytes);
+    printf("Holes: %d, largest %ld bytes, external fragmentation %.2f%%\n", memory->holeCount, largest, external);
+    printf("Processes: %ld, internal fragmentation %ld bytes\n", (long) memory->processes.count, memory->internalFragmentation);
+    printf("Compactions: %ld, moved %ld bytes in %ld blocks\n", memory->compactions, memory->compactedBytes, memory->compactedBlocks);
+    printf("Block pool: %ld live, %ld high water, %ld hits, %ld misses, %ld chunks\n",
+           memory->pool.live, memory->pool.highWater, memory->pool.hits, memory->pool.misses, memory->pool.chunkCount);
+    if (memory->quickRequests > 0) {
+        printf("Quick lists: %ld blocks, %ld bytes, %ld of %ld requests hit (%.2f%%), %ld consolidations\n",
+               memory->quickBlocks, memory->quickBytes, memory->quickHits, memory->quickRequests,
+               100.0 * memory->quickHits / memory->quickRequests, memory->consolidations);
+    }
+    if (memory->resizes > 0) {
+        printf("Resizes: %ld, %ld in place (%.2f%%), moved %ld bytes\n", memory->resizes, memory->resizesInPlace,
+               100.0 * memory->resizesInPlace / memory->resizes, memory->resizeBytesMoved);
+    }
+}
+
+
+AllocSimResult allocsim_compact(AllocSim *memory, long targetHole, long *bytesMoved){
+    long bytes = 0;
+    int blocks = 0;
+    AllocSimResult result = compactBlocks(memory, targetHole, &bytes, &blocks);
+    if (bytesMoved != NULL) *bytesMoved = bytes;
+    return result;
+}
+
+void compact(Memory *memory, long targetHole){
+
+/* TODO*/
+
+/*
+Compacts the memory allocations by shifting all current allocations to the top and combining all holes into a single hole.
+If targetHole > 0, compaction stops as soon as a hole of at least targetHole bytes exists (partial compaction).
+*/
+    long bytesMoved = 0; // bytes of process memory that changed address
+    int blocksMoved = 0; // process blocks that changed address
+
+    PROFILE_START(started);
+    AllocSimResult result = compactBlocks(memory, targetHole, &bytesMoved, &blocksMoved);
+    PROFILE_TIMER(memory, PROFILE_COMPACT, started);
+    if (result != ALLOCSIM_OK) printResult(memory, result);
+    else reportCompaction(memory, bytesMoved, blocksMoved);
+}
+
+
+// turns the structure of arrays block table on or off -> first-fit scans it while on
+void setBlockTable(Memory *memory, bool enabled){
+    memory->useTable = enabled;
+    if (tableActive(memory)) tableRebuild(&memory->table, memory->head);
+}
+
+void setLegacyBestFit(Memory *memory, bool enabled){ memory->legacyBestFit = enabled; }
+
+
+void printError(Memory *memory, const char *error){
+
+/* TODO*/
+
+/*
+Prints an error message to the screen.
+*/
+    if (memory == NULL || !memory->scripted_mode) { // errors without a memory always print
+
+        fprintf(stderr, "%s\n", error); // print error to standard error output stream
+    }
+}
+
+
+
+
+
+// ************************************** SNAPSHOT *************************************
+// SAVE and LOAD -> blocks are written as fixed size records in address order, so LOAD maps the file and
+// rebuilds the list, PID table and hole index in one pass without searching for anything
+// snapshot layout: SnapshotHeader, blockCount SnapshotBlocks, freeCount bases of free blocks in free list order
+// buddy and TLSF pick the first block of a free list and quick lists hand out their top, so list order is state too
+
+#define SNAPSHOT_MAGIC "ALLOCSNP" // first 8 bytes of every snapshot, no NUL
+#define SNAPSHOT_VERSION 1
+
+#define SNAPSHOT_AUTOC 1 // flags -> modes that were on when the snapshot was saved
+#define SNAPSHOT_SOA 2
+#define SNAPSHOT_FAST 4
+
+typedef enum { SNAPSHOT_HOLE, SNAPSHOT_PROCESS, SNAPSHOT_LONG_PROCESS, SNAPSHOT_QUICK } SnapshotKind;
+
+typedef struct {
+    char magic[8];                   // SNAPSHOT_MAGIC
+    unsigned int version;            // SNAPSHOT_VERSION
+    unsigned int engine;             // Engine that owned the memory
+    unsigned int flags;              // SNAPSHOT_AUTOC, SNAPSHOT_SOA and SNAPSHOT_FAST
+    unsigned int unused;             // keeps the counts 8 byte aligned
+    long long totalMemory;
+    unsigned long long blockCount;   // records after the header
+    unsigned long long processCount; // process records -> sizes the PID table up front
+    unsigned long long freeCount;    // free list entries -> one per hole and quick-listed block
+} SnapshotHeader;
+
+typedef struct {
+    long long base;          // start address -> records are back to back from address 0
+    long long limit;         // number of bytes
+    long long requested;     // bytes the process asked for -> 0 for free blocks
+    char PID[10];            // process id name -> HOLE_PID for free blocks
+    unsigned char kind;      // SnapshotKind
+    unsigned char unused[5]; // keeps records 40 bytes
+} SnapshotBlock;
+
+// appends one entry of the free list order
+bool writeFreeBase(FILE *file, Block *b, unsigned long long *count){
+    long long base = b->base;
+    (*count)++;
+    return fwrite(&base, sizeof(base), 1, file) == 1;
+}
+
+// writes the base of every free block, each free list from first to last -> false if a write failed
+bool writeFreeOrder(Memory *memory, FILE *file, unsigned long long *count){
+    bool written = true;
+
+    if (memory->engine == ENGINE_LIST) { // holesBySize orders itself, address order is as good as any
+        for (Block *current = memory->head; current != NULL && written; current = current->next) {
+            if (isHole(current)) written = writeFreeBase(file, current, count);
+        }
+    } else if (memory->engine == ENGINE_BUDDY) {
+        for (int order = 0; order < BUDDY_MAX_ORDER; order++) {
+            for (Block *b = memory->buddyFree[order]; b != NULL && written; b = b->freeNext) written = writeFreeBase(file, b, count);
+        }
+    } else {
+        for (int fl = 0; fl < TLSF_FL_COUNT; fl++) {
+            for (int sl = 0; sl < TLSF_SL_COUNT; sl++) {
+                for (Block *b = memory->tlsf.lists[fl][sl]; b != NULL && written; b = b->freeNext) written = writeFreeBase(file, b, count);
+            }
+        }
+    }
+    for (int i = 0; i < QUICK_BINS; i++) {
+        for (Block *b = memory->quick[i].top; b != NULL && written; b = b->freeNext) written = writeFreeBase(file, b, count);
+    }
+    return written;
+}
+
+AllocSimResult saveSnapshot(Memory *memory, const char *path){
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return ALLOCSIM_ERR_IO;
+    setvbuf(file, NULL, _IOFBF, 1 << 20); // records are small, write them in big chunks
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.engine = memory->engine;
+    header.flags = (memory->compactOnFailure ? SNAPSHOT_AUTOC : 0) | (memory->useTable ? SNAPSHOT_SOA : 0) |
+                   (memory->useQuick ? SNAPSHOT_FAST : 0);
+    header.totalMemory = memory->total_memory;
+    header.processCount = memory->processes.count;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1; // rewritten with blockCount at the end
+    for (Block *current = memory->head; current != NULL && written; current = current->next) {
+        SnapshotBlock record;
+        memset(&record, 0, sizeof(record));
+        record.base = current->base;
+        record.limit = current->limit;
+        record.requested = isFree(current) ? 0 : current->requested;
+        strcpy(record.PID, current->PID);
+        record.kind = isHole(current) ? SNAPSHOT_HOLE : isFast(current) ? SNAPSHOT_QUICK :
+                      current->longLived ? SNAPSHOT_LONG_PROCESS : SNAPSHOT_PROCESS;
+        written = fwrite(&record, sizeof(record), 1, file) == 1;
+        header.blockCount++;
+    }
+    written = written && writeFreeOrder(memory, file, &header.freeCount);
+    written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    if (fclose(file) != 0) written = false;
+    return written ? ALLOCSIM_OK : ALLOCSIM_ERR_IO;
+}
+
+// checks a record against the block before it -> the rules every engine keeps for its list
+bool validRecord(const SnapshotHeader *header, const SnapshotBlock *record, const SnapshotBlock *previous, long end){
+    if (record->base != end || record->limit <= 0 || record->limit > header->totalMemory - end) return false;
+    if (record->kind > SNAPSHOT_QUICK || memchr(record->PID, '\0', sizeof(record->PID)) == NULL) return false;
+
+    if (record->kind == SNAPSHOT_PROCESS || record->kind == SNAPSHOT_LONG_PROCESS) {
+        if (record->requested <= 0 || record->requested > record->limit) return false;
+        if (record->PID[0] == '\0' || strcmp(record->PID, HOLE_PID) == 0) return false;
+    } else if (strcmp(record->PID, HOLE_PID) != 0) {
+        return false;
+    }
+
+    if (header->engine == ENGINE_BUDDY) { // power of two blocks on their own alignment, never quick-listed
+        if ((record->limit & (record->limit - 1)) != 0 || record->base % record->limit != 0) return false;
+        if (record->limit > 1LL << (BUDDY_MAX_ORDER - 1) || record->kind == SNAPSHOT_QUICK) return false;
+    } else if (record->kind == SNAPSHOT_HOLE && previous != NULL && previous->kind == SNAPSHOT_HOLE) {
+        return false; // list and TLSF holes are always merged
+    } else if (record->kind == SNAPSHOT_QUICK && !(header->flags & SNAPSHOT_FAST)) {
+        return false;
+    }
+    return true;
+}
+
+// pushes free blocks in reverse free list order, so every list ends up in its saved order
+// freeBlocks is in address order and freeBases holds their bases -> false if an entry names no free block or one that is already pushed
+bool restoreFreeOrder(Memory *memory, Block **freeBlocks, const long *freeBases, const long long *order, unsigned long long count){
+    unsigned char *pushed = (unsigned char *) calloc(count + 1, 1);
+    bool valid = true;
+
+    for (unsigned long long i = count; i > 0 && valid; i--) {
+        unsigned long long low = 0, high = count; // binary search for the block at order[i - 1]
+        while (low < high) {
+            unsigned long long middle = low + (high - low) / 2;
+            if (freeBases[middle] < order[i - 1]) low = middle + 1; // bases are searched apart from the blocks to stay in cache
+            else high = middle;
+        }
+        valid = low < count && freeBases[low] == order[i - 1] && !pushed[low];
+        if (!valid) break;
+        pushed[low] = 1;
+
+        Block *b = freeBlocks[low];
+        if (isFast(b)) {
+            QuickBin *bin = quickBin(memory, b->limit);
+            valid = bin != NULL; // every bin holds a single size
+            if (valid) quickPush(memory, bin, b);
+        } else if (memory->engine == ENGINE_BUDDY) {
+            buddyPush(memory, b, blockOrder(b));
+        } else {
+            indexHole(memory, b);
+        }
+    }
+    free(pushed);
+    return valid;
+}
+
+// builds a memory from mapped snapshot records and free list order -> NULL if any of it is broken
+Memory *restoreMemory(const SnapshotHeader *header, const SnapshotBlock *records, const long long *order, bool scripted_mode){
+    if (header->engine > ENGINE_TLSF || header->totalMemory <= 0 || header->totalMemory > LONG_MAX) return NULL;
+    if (header->processCount > header->blockCount) return NULL;
+
+    Memory *memory = createMemory(header->totalMemory, scripted_mode);
+    unindexHole(memory, memory->head); // start without the GIANT hole
+    destroyBlock(&memory->pool, memory->head);
+    memory->head = NULL;
+    memory->engine = header->engine;
+    memory->compactOnFailure = (header->flags & SNAPSHOT_AUTOC) != 0;
+    memory->useTable = (header->flags & SNAPSHOT_SOA) != 0;
+    memory->useQuick = (header->flags & SNAPSHOT_FAST) != 0;
+
+    size_t capacity = PID_TABLE_MIN_CAPACITY;
+    while (capacity < 2 * (header->processCount + 1)) capacity *= 2;
+    free(memory->processes.slots);
+    pidTableInit(&memory->processes, capacity); // big enough that no insert has to grow it
+
+    Block **freeBlocks = (Block **) malloc(sizeof(Block *) * (header->freeCount + 1)); // free blocks in address order
+    long *freeBases = (long *) malloc(sizeof(long) * (header->freeCount + 1));
+    unsigned long long freeFound = 0;
+    Block *last = NULL;
+    long end = 0;
+    bool valid = true;
+    for (unsigned long long i = 0; i < header->blockCount && valid; i++) {
+        const SnapshotBlock *record = &records[i];
+        valid = validRecord(header, record, i > 0 ? &records[i - 1] : NULL, end);
+        if (!valid) break;
+
+        bool process = record->kind == SNAPSHOT_PROCESS || record->kind == SNAPSHOT_LONG_PROCESS;
+        size_t slot = process ? pidTableSlot(&memory->processes, record->PID) : 0;
+        valid = !process || memory->processes.slots[slot] == NULL; // no duplicate PIDs
+        if (!valid) break;
+
+        unsigned int pid = process ? internPID(&memory->names, record->PID) : record->kind == SNAPSHOT_QUICK ? FAST_ID : HOLE_ID;
+        Block *b = createBlock(&memory->pool, record->PID, pid, record->base, record->limit);
+        b->prev = last;
+        if (last == NULL) memory->head = b;
+        else last->next = b;
+        last = b;
+        end += record->limit;
+
+        if (process) {
+            b->requested = record->requested;
+            b->longLived = record->kind == SNAPSHOT_LONG_PROCESS;
+            if (b->longLived) memory->longLived++;
+            memory->internalFragmentation += record->limit - record->requested;
+            memory->processes.slots[slot] = b; // table is big enough, no need to grow like pidTableInsert
+            memory->processes.count++;
+        } else {
+            valid = freeFound < header->freeCount;
+            if (!valid) break;
+            freeBlocks[freeFound] = b; // pushed once every free block is known
+            freeBases[freeFound++] = b->base;
+        }
+    }
+
+    valid = valid && end == memory->total_memory && memory->processes.count == header->processCount &&
+            freeFound == header->freeCount && restoreFreeOrder(memory, freeBlocks, freeBases, order, freeFound);
+    free(freeBlocks);
+    free(freeBases);
+    if (!valid) {
+        destroyMemory(memory);
+        return NULL;
+    }
+    if (tableActive(memory)) tableRebuild(&memory->table, memory->head);
+    return memory;
+}
+
+AllocSimResult loadSnapshot(Memory *memory, const char *path){
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return ALLOCSIM_ERR_IO;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return ALLOCSIM_ERR_IO;
+    }
+    size_t size = (size_t) info.st_size;
+    if (size < sizeof(SnapshotHeader)) {
+        close(fd);
+        return ALLOCSIM_ERR_BAD_SNAPSHOT;
+    }
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file open
+    if (mapping == MAP_FAILED) return ALLOCSIM_ERR_IO;
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    const SnapshotHeader *header = (const SnapshotHeader *) mapping;
+    size_t bytes = size - sizeof(SnapshotHeader); // records and free list order
+    Memory *loaded = NULL;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 && header->version == SNAPSHOT_VERSION &&
+        header->blockCount <= bytes / sizeof(SnapshotBlock)) {
+        bytes -= header->blockCount * sizeof(SnapshotBlock);
+        const SnapshotBlock *records = (const SnapshotBlock *) (header + 1);
+        if (bytes % sizeof(long long) == 0 && header->freeCount == bytes / sizeof(long long)) {
+            loaded = restoreMemory(header, records, (const long long *) (records + header->blockCount), memory->scripted_mode);
+        }
+    }
+    munmap(mapping, size);
+    if (loaded == NULL) return ALLOCSIM_ERR_BAD_SNAPSHOT;
+
+    Memory previous = *memory; // swap contents so the caller's handle now holds the loaded memory
+    *memory = *loaded;
+    *loaded = previous;
+    memory->legacyBestFit = previous.legacyBestFit; // front end setting, not part of the snapshot
+#ifdef ALLOCATOR_PROFILE
+    memory->profile = previous.profile; // profiling goes on across LOAD
+#endif
+    destroyMemory(loaded);
+    return ALLOCSIM_OK;
+}
+
+
+bool saveMemory(Memory *memory, const char *path){
+    AllocSimResult result = saveSnapshot(memory, path);
+    if (result != ALLOCSIM_OK) {
+        printResult(memory, result);
+        return false;
+    }
+    if (!memory->scripted_mode) printf("Saved %ld blocks to %s\n", memory->pool.live, path);
+    return true;
+}
+
+
+bool loadMemory(Memory *memory, const char *path){
+    AllocSimResult result = loadSnapshot(memory, path);
+    if (result != ALLOCSIM_OK) {
+        printResult(memory, result);
+        return false;
+    }
+    if (!memory->scripted_mode) printf("Loaded %ld blocks, %ld bytes of memory from %s\n", memory->pool.live, memory->total_memory, path);
+    return true;
+}
+
+// *************************************************************************************
+
+
+
+#ifdef ALLOCATOR_PROFILE
+
+// ************************************** PROFILE **************************************
+
+long profileClock(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+void histogramAdd(LatencyHistogram *histogram, long nanoseconds){
+    int bucket = 63 - __builtin_clzll((unsigned long long) nanoseconds | 1); // floor(log2) of the latency
+    if (bucket >= PROFILE_BUCKETS) bucket = PROFILE_BUCKETS - 1;
+
+    histogram->count++;
+    histogram->totalNanoseconds += nanoseconds;
+    if (nanoseconds > histogram->maxNanoseconds) histogram->maxNanoseconds = nanoseconds;
+    histogram->buckets[bucket]++;
+}
+
+// adds one dispatched command -> names that are not lowercase words or don't fit in the table count as "other"
+void profileCommand(Memory *memory, const char *name, long nanoseconds){
+    Profile *profile = &memory->profile;
+    bool word = name[0] != '\0' && strlen(name) < sizeof(profile->commands[0].name);
+    for (int i = 0; name[i] && word; i++) word = islower((unsigned char) name[i]) || isdigit((unsigned char) name[i]) || name[i] == '_';
+    if (!word) name = "other";
+
+    int i = 0;
+    while (i < profile->commandCount && strcmp(profile->commands[i].name, name) != 0) i++;
+    if (i == profile->commandCount) { // first time this command runs
+        if (profile->commandCount == PROFILE_COMMANDS) {
+            profileCommand(memory, "other", nanoseconds);
+            return;
+        }
+        strcpy(profile->commands[profile->commandCount++].name, name);
+    }
+    histogramAdd(&profile->commands[i].latency, nanoseconds);
+}
+
+// latency below which fraction of the calls finished -> upper end of the bucket, never more than the maximum
+long histogramPercentile(const LatencyHistogram *histogram, double fraction){
+    long seen = 0;
+    for (int i = 0; i < PROFILE_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen > 0 && seen >= fraction * histogram->count) {
+            long upper = (2L << i) - 1;
+            return upper < histogram->maxNanoseconds ? upper : histogram->maxNanoseconds;
+        }
+    }
+    return histogram->maxNanoseconds;
+}
+
+void printHistogram(FILE *out, const char *section, const char *name, const LatencyHistogram *histogram, bool csv, bool first){
+    long mean = histogram->count > 0 ? histogram->totalNanoseconds / histogram->count : 0;
+    long p50 = histogramPercentile(histogram, 0.50);
+    long p99 = histogramPercentile(histogram, 0.99);
+
+    if (csv) {
+        fprintf(out, "%s,%s,count,%ld\n%s,%s,total_ns,%ld\n%s,%s,mean_ns,%ld\n%s,%s,max_ns,%ld\n%s,%s,p50_ns,%ld\n%s,%s,p99_ns,%ld\n",
+                section, name, histogram->count, section, name, histogram->totalNanoseconds, section, name, mean,
+                section, name, histogram->maxNanoseconds, section, name, p50, section, name, p99);
+        for (int i = 0; i < PROFILE_BUCKETS; i++) {
+            if (histogram->buckets[i] > 0) fprintf(out, "%s,%s,bucket_%ld_ns,%ld\n", section, name, 1L << i, histogram->buckets[i]);
+        }
+        return;
+    }
+
+    fprintf(out, "%s\n    \"%s\": {\"count\": %ld, \"total_ns\": %ld, \"mean_ns\": %ld, \"max_ns\": %ld, \"p50_ns\": %ld, \"p99_ns\": %ld, \"buckets\": {",
+            first ? "" : ",", name, histogram->count, histogram->totalNanoseconds, mean, histogram->maxNanoseconds, p50, p99);
+    bool firstBucket = true;
+    for (int i = 0; i < PROFILE_BUCKETS; i++) { // keyed by the lower end of the bucket in nanoseconds
+        if (histogram->buckets[i] == 0) continue;
+        fprintf(out, "%s\"%ld\": %ld", firstBucket ? "" : ", ", 1L << i, histogram->buckets[i]);
+        firstBucket = false;
+    }
+    fprintf(out, "}}");
+}
+
+// PROF -> every counter and histogram of memory, as one JSON object or as section,name,field,value CSV rows
+void printProfile(Memory *memory, FILE *out, bool csv){
+    Profile *profile = &memory->profile;
+    const char *counterNames[] = { "nodes_visited", "splits", "merges", "block_allocs", "block_frees", "chunk_mallocs",
+                                   "compactions", "compacted_bytes", "resize_bytes_moved" };
+    long blockAllocs = memory->pool.hits + memory->pool.misses; // blocks come from the pool, malloc only runs per chunk
+    long counters[] = { nodesVisited(memory), profile->splits, profile->merges, blockAllocs, blockAllocs - memory->pool.live,
+                        memory->pool.chunkCount, memory->compactions, memory->compactedBytes, memory->resizeBytesMoved };
+    int counterCount = sizeof(counters) / sizeof(counters[0]);
+
+    if (csv) {
+        fprintf(out, "section,name,field,value\n");
+        for (int i = 0; i < counterCount; i++) fprintf(out, "counter,%s,value,%ld\n", counterNames[i], counters[i]);
+        for (int i = 0; i < PROFILE_TIMERS; i++) printHistogram(out, "timer", PROFILE_TIMER_NAMES[i], &profile->timers[i], true, false);
+        for (int i = 0; i < profile->commandCount; i++) {
+            printHistogram(out, "command", profile->commands[i].name, &profile->commands[i].latency, true, false);
+        }
+        fflush(out);
+        return;
+    }
+
+    fprintf(out, "{\n  \"counters\": {");
+    for (int i = 0; i < counterCount; i++) fprintf(out, "%s\n    \"%s\": %ld", i == 0 ? "" : ",", counterNames[i], counters[i]);
+    fprintf(out, "\n  },\n  \"timers\": {");
+    for (int i = 0; i < PROFILE_TIMERS; i++) printHistogram(out, "timer", PROFILE_TIMER_NAMES[i], &profile->timers[i], false, i == 0);
+    fprintf(out, "\n  },\n  \"commands\": {");
+    for (int i = 0; i < profile->commandCount; i++) {
+        printHistogram(out, "command", profile->commands[i].name, &profile->commands[i].latency, false, i == 0);
+    }
+    fprintf(out, "\n  }\n}\n");
+    fflush(out);
+}
+
+// *************************************************************************************
+
+#endif
+
+
+
+// **************************************** API ****************************************
+// handle based entry points of liballocsim.a -> an AllocSim is a Memory that never prints
+
+AllocSim *allocsim_create(long total_memory){
+    return total_memory > 0 ? createMemory(total_memory, true) : NULL;
+}
+
+void allocsim_destroy(AllocSim *sim){
+    if (sim != NULL) destroyMemory(sim);
+}
+
+int copyVisitor(const AllocSimBlock *block, void *copy){
+    *(AllocSimBlock *) copy = *block;
+    return 1; // the first block holds the address
+}
+
+AllocSimResult allocsim_block_at(AllocSim *sim, long address, AllocSimBlock *block){
+    if (address < 0 || address >= sim->total_memory) return ALLOCSIM_ERR_INVALID_ADDRESS;
+    allocsim_walk(sim, address, address, copyVisitor, block);
+    return ALLOCSIM_OK;
+}
+
+void allocsim_stats(AllocSim *sim, AllocSimStats *stats){
+    stats->totalMemory = sim->total_memory;
+    stats->allocatedBytes = sim->total_memory - sim->freeBytes - sim->quickBytes;
+    stats->freeBytes = sim->freeBytes;
+    stats->largestHole = largestHole(sim);
+    stats->holes = sim->holeCount;
+    stats->processes = (long) sim->processes.count;
+    stats->internalFragmentation = sim->internalFragmentation;
+    stats->compactions = sim->compactions;
+    stats->compactedBytes = sim->compactedBytes;
+    stats->compactedBlocks = sim->compactedBlocks;
+    stats->nodesVisited = nodesVisited(sim);
+    stats->quickBlocks = sim->quickBlocks;
+    stats->quickBytes = sim->quickBytes;
+    stats->quickRequests = sim->quickRequests;
+    stats->quickHits = sim->quickHits;
+    stats->consolidations = sim->consolidations;
+    stats->resizes = sim->resizes;
+    stats->resizesInPlace = sim->resizesInPlace;
+    stats->resizeBytesMoved = sim->resizeBytesMoved;
+}
+
+void allocsim_set_compact_on_failure(AllocSim *sim, int enabled){ sim->compactOnFailure = enabled ? true : false; }
+
+void allocsim_set_block_table(AllocSim *sim, int enabled){ setBlockTable(sim, enabled ? true : false); }
+
+void allocsim_set_quick_lists(AllocSim *sim, int enabled){ setQuickLists(sim, enabled ? true : false); }
+
+void allocsim_consolidate(AllocSim *sim){ consolidate(sim); }
+
+AllocSimResult allocsim_save(AllocSim *sim, const char *path){ return saveSnapshot(sim, path); }
+
+AllocSimResult allocsim_load(AllocSim *sim, const char *path){ return loadSnapshot(sim, path); }
+
+const char *allocsim_strerror(AllocSimResult result){
+    switch (result) {
+        case ALLOCSIM_OK: return "Success.";
+        case ALLOCSIM_ERR_PID_EXISTS: return "Given PID already exists!";
+        case ALLOCSIM_ERR_PID_NOT_FOUND: return "Given PID does not exist in memory.";
+        case ALLOCSIM_ERR_INVALID_PID: return "Invalid PID, must be 1 to 9 characters and not Unused.";
+        case ALLOCSIM_ERR_INVALID_SIZE: return "Invalid memory request size.";
+        case ALLOCSIM_ERR_INVALID_STRATEGY: return "Invalid allocation strategy, must be F, B, W, Y, or T.";
+        case ALLOCSIM_ERR_ENGINE_BUSY: return "Allocation engine can only change while memory is empty.";
+        case ALLOCSIM_ERR_NO_MEMORY: return "Insufficient memory to allocate to the request.";
+        case ALLOCSIM_ERR_UNSUPPORTED: return "Compaction is not supported by the buddy allocator.";
+        case ALLOCSIM_ERR_INVALID_ADDRESS: return "Address is outside memory.";
+        case ALLOCSIM_ERR_NO_PROCESS_AT: return "No process starts at the given address.";
+        case ALLOCSIM_ERR_INVALID_LIFETIME: return "Invalid lifetime hint, must be SHORT or LONG.";
+        case ALLOCSIM_ERR_IO: return "Snapshot file could not be opened, read or written.";
+        case ALLOCSIM_ERR_BAD_SNAPSHOT: return "File is not a valid snapshot.";
+    }
+    return "Unknown error.";
+}
+
+// *************************************************************************************
@@ -0,0 +1,97 @@
+#ifndef ALLOCSIM_H
+#define ALLOCSIM_H
+
+// handle based C API of the simulator -> liballocsim.a
+// calls never print, every failure comes back as an AllocSimResult
+// handles share no state, so independent handles can be driven from different threads without locking
+
+#define ALLOCSIM_PID_MAX 9 // longest PID a block can hold
+
+typedef struct Memory AllocSim; // one simulated memory -> same object as Memory in allocator.h
+
+typedef enum {
+    ALLOCSIM_OK = 0,
+    ALLOCSIM_ERR_PID_EXISTS,       // RQ of a PID that is already allocated
+    ALLOCSIM_ERR_PID_NOT_FOUND,    // RL of a PID that is not allocated
+    ALLOCSIM_ERR_INVALID_PID,      // empty, longer than ALLOCSIM_PID_MAX or the name of holes
+    ALLOCSIM_ERR_INVALID_SIZE,     // size <= 0
+    ALLOCSIM_ERR_INVALID_STRATEGY, // not F, B, W, Y or T
+    ALLOCSIM_ERR_ENGINE_BUSY,      // list, buddy and TLSF engines can only change while memory is empty
+    ALLOCSIM_ERR_NO_MEMORY,        // no hole fits the request
+    ALLOCSIM_ERR_UNSUPPORTED,      // compaction of buddy blocks
+    ALLOCSIM_ERR_INVALID_ADDRESS,  // address < 0 or past the end of memory
+    ALLOCSIM_ERR_NO_PROCESS_AT,    // RL @address where no process block starts
+    ALLOCSIM_ERR_INVALID_LIFETIME, // lifetime hint that is neither SHORT nor LONG
+    ALLOCSIM_ERR_IO,               // snapshot file could not be opened, read or written
+    ALLOCSIM_ERR_BAD_SNAPSHOT      // LOAD of a file that is not a snapshot or breaks the block rules
+} AllocSimResult;
+
+typedef enum {
+    ALLOCSIM_LIFETIME_SHORT = 0, // placed from the low end of memory -> what allocsim_request does
+    ALLOCSIM_LIFETIME_LONG       // placed from the high end of memory and compacted towards it
+} AllocSimLifetime;
+
+typedef struct {
+    long totalMemory;
+    long allocatedBytes;        // bytes in process blocks
+    long freeBytes;             // bytes in holes -> quick-listed bytes are counted in quickBytes
+    long largestHole;
+    long holes;
+    long processes;
+    long internalFragmentation; // bytes handed out to processes beyond what they requested
+    long compactions;
+    long compactedBytes;        // bytes moved by every compaction so far
+    long compactedBlocks;       // process blocks moved by every compaction so far
+    long nodesVisited;          // blocks and index nodes inspected while searching for holes
+    long quickBlocks;           // freed blocks waiting in quick lists
+    long quickBytes;
+    long quickRequests;         // RQs made while quick lists were on
+    long quickHits;             // RQs served straight from a quick list
+    long consolidations;        // times the quick lists were merged back into holes
+    long resizes;               // RS calls that succeeded
+    long resizesInPlace;        // resizes served from the block and its neighbouring holes
+    long resizeBytesMoved;      // process bytes copied by resizes that moved the block
+} AllocSimStats;
+
+typedef struct {
+    const char *PID; // process id name, NULL for a hole -> only valid during the visit
+    long base;       // start address
+    long limit;      // number of bytes
+    long requested;  // bytes the process asked for -> 0 for a hole
+} AllocSimBlock;
+
+typedef struct {
+    const char *PID;       // process id name
+    long size;             // bytes requested
+    long address;          // set by allocsim_request_batch -> base of the new process block, -1 if the request failed
+    AllocSimResult result; // set by allocsim_request_batch
+} AllocSimRequest;
+
+typedef int (*AllocSimVisitor)(const AllocSimBlock *block, void *context); // nonzero stops the walk
+
+AllocSim *allocsim_create(long total_memory); // memory as one hole -> NULL if total_memory <= 0
+void allocsim_destroy(AllocSim *sim);
+
+AllocSimResult allocsim_request(AllocSim *sim, const char *PID, long size, char strategy, long *address); // RQ -> address may be NULL
+AllocSimResult allocsim_request_hint(AllocSim *sim, const char *PID, long size, char strategy,
+                                     AllocSimLifetime lifetime, long *address);                           // RQ ... SHORT|LONG
+long allocsim_request_batch(AllocSim *sim, AllocSimRequest *requests, long count, char strategy);        // RQB -> returns the number of requests placed
+AllocSimResult allocsim_release(AllocSim *sim, const char *PID);                                         // RL
+AllocSimResult allocsim_resize(AllocSim *sim, const char *PID, long size, char strategy, long *address);  // RS -> strategy 0 moves with F, Y or T by engine
+AllocSimResult allocsim_release_at(AllocSim *sim, long address);                                         // RL @address -> address is the base of a process block
+AllocSimResult allocsim_block_at(AllocSim *sim, long address, AllocSimBlock *block);                     // WHO -> block that holds address
+AllocSimResult allocsim_compact(AllocSim *sim, long targetHole, long *bytesMoved);                        // C -> bytesMoved may be NULL
+long allocsim_walk(AllocSim *sim, long start, long end, AllocSimVisitor visit, void *context); // STAT -> blocks overlapping [start:end] in address order, returns blocks visited
+void allocsim_stats(AllocSim *sim, AllocSimStats *stats);                                     // STATS -> running counters, largest hole O(log n) on the list engine, O(1) on buddy and on TLSF unless its biggest hole left since the last call
+
+void allocsim_set_compact_on_failure(AllocSim *sim, int enabled); // AUTOC ON|OFF
+void allocsim_set_block_table(AllocSim *sim, int enabled);        // SOA ON|OFF
+void allocsim_set_quick_lists(AllocSim *sim, int enabled);        // FAST ON|OFF -> off merges every quick-listed block
+void allocsim_consolidate(AllocSim *sim);                         // CONSOLIDATE
+
+AllocSimResult allocsim_save(AllocSim *sim, const char *path); // SAVE -> binary snapshot of every block and mode
+AllocSimResult allocsim_load(AllocSim *sim, const char *path); // LOAD -> replaces sim with the snapshot, sim is unchanged on failure
+
+const char *allocsim_strerror(AllocSimResult result); // message printed by the allocator program for result
+
+#endif
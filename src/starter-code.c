@@ -2,510 +2,1274 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "allocator.h"
+#include "allocsim.h"
+
+// allocator program -> text commands, scripts, traces, sweeps and the socket server on top of liballocsim.a
 
-typedef enum { false, true } bool; // for returning bool in isHole and hasEnoughSpace functions since I can't add the library stdbool.h based on assignment restrictions
-void printError(char *error); // function prototype for early calls
-int scripted_mode = 0; // global variable to keep track if scripted mode is on or off -> affects printError
-const char *HOLE_PID = "Unused";
-
-// *************************************** BLOCK ***************************************
-// doubly linked list structure for memory -> blocks are nodes
-typedef struct Block {
-    char PID[10];         // process id name -> "Unused" if unused
-    int base;   // start address
-    int limit;  // number of bytes 
-    struct Block *prev; // pointer to previous block
-    struct Block *next;   // pointer to next block
-} Block;
-
-// block constructor
-Block *createBlock(const char *PID, int base, int limit) {
-    Block *newBlock = (Block *) malloc(sizeof(Block)); // allocate memory to hold a Block
-    strcpy(newBlock->PID, PID); // set process id name of the new block
-    newBlock->base = base; // set base
-    newBlock->limit = limit; // set limit
-    newBlock->prev = NULL; // set new block's prev pointer to null
-    newBlock->next = NULL; // set new block's next pointer to null
-    return newBlock; // return pointer to new block
-}
-
-// checks if memory block is a hole
-bool isHole(Block *b){ return strcmp(b->PID, HOLE_PID) == 0; }
-
-// checks if memory block has enough space
-bool hasEnoughSpace (Block *b, int size){ return b->limit >= size; }
-
-// printer for block to use for STAT
-void printBlock(Block *b) {
-    int start = b->base;
-    int end = b->base + b->limit - 1;
-
-    if (isHole(b)) {
-        printf("Addresses [%d:%d] Unused\n", start, end); // handles hole case print
-    } else {
-        printf("Addresses [%d:%d] Process %s\n", start, end, b->PID); // handles non-hole case print
+// ********************************* helper functions **********************************
+
+// Converts a string to lowercase
+void lowercase(char *s) {
+    // source for tolower() : https://www.geeksforgeeks.org/tolower-function-in-c/
+
+    for (int i = 0; s[i]; i++) {
+        s[i] = tolower(s[i]);
     }
+    
 }
 
 // *************************************************************************************
 
 
+// turns compact-on-failure for RQ on or off
+void setCompactOnFailure(Memory *memory, char *mode){
+    lowercase(mode);
 
-// *************************************** MEMORY **************************************
-// linked list structure for memory
+    if (strcmp(mode, "on") == 0) allocsim_set_compact_on_failure(memory, true);
+    else if (strcmp(mode, "off") == 0) allocsim_set_compact_on_failure(memory, false);
+    else printError(memory, "ERROR: Compact on failure mode must be ON or OFF.");
+}
 
-typedef struct {
-    Block *head;       // pointer to start of memory blocks -> head pointer of linked list
-    int total_memory;  // size of the memory 
-} Memory;
 
+// turns the structure of arrays block table on or off from SOA ON|OFF
+void setBlockTableMode(Memory *memory, char *mode){
+    lowercase(mode);
 
-Memory memory;  // Global memory initiated
+    if (strcmp(mode, "on") == 0) setBlockTable(memory, true);
+    else if (strcmp(mode, "off") == 0) setBlockTable(memory, false);
+    else printError(memory, "ERROR: Block table mode must be ON or OFF.");
+}
 
 
-// function for checking that there are no processes with the same PID
-bool pidExists(const char *PID){
-    // used for not allowing duplicate PID names
+// turns quick lists with deferred merging on or off from FAST ON|OFF
+void setQuickListsMode(Memory *memory, char *mode){
+    lowercase(mode);
 
-    Block *current = memory.head;
+    if (strcmp(mode, "on") == 0) setQuickLists(memory, true);
+    else if (strcmp(mode, "off") == 0) setQuickLists(memory, false);
+    else printError(memory, "ERROR: Quick list mode must be ON or OFF.");
+}
 
-    while (current != NULL){
-        if (!isHole(current) && strcmp(current->PID, PID) == 0){ // pass holes and check if process with given PID already exists
-            return true;
-        } 
-        current = current->next; // update current pointer
+
+// PROF [JSON|CSV] [file] -> format NULL means JSON, prints the profile to standard output or writes it to file
+void printProfileMode(Memory *memory, char *format, char *fileName){
+#ifdef ALLOCATOR_PROFILE
+    if (format == NULL) format = "json";
+    else lowercase(format);
+    if (strcmp(format, "json") != 0 && strcmp(format, "csv") != 0) {
+        printError(memory, "ERROR: Profile format must be JSON or CSV.");
+        return;
     }
-    return false;
-} 
+
+    FILE *out = fileName != NULL ? fopen(fileName, "w") : stdout;
+    if (out == NULL) {
+        printError(memory, "ERROR: Could not open profile file.");
+        return;
+    }
+    printProfile(memory, out, strcmp(format, "csv") == 0);
+    if (out != stdout) fclose(out);
+#else
+    (void) format;
+    (void) fileName;
+    printError(memory, "ERROR: Profiling is not compiled in, build with make PROFILE=1.");
+#endif
+}
+
+
+// profile builds dump every counter and histogram as JSON to standard error when the program ends
+void printProfileAtExit(Memory *memory){
+#ifdef ALLOCATOR_PROFILE
+    printProfile(memory, stderr, false);
+#else
+    (void) memory;
+#endif
+}
 
 // *************************************************************************************
 
 
 
+// *************************************** SCRIPT **************************************
+// scripted mode input -> text scripts are memory mapped and tokenized in place, binary traces are replayed directly
+// binary trace layout: TraceHeader, pidBytes of NUL terminated PID strings, padding to 8 bytes, opCount TraceOps
 
-// ********************************* helper functions **********************************
+#define TRACE_MAGIC "ALLOCTRC"
+#define TRACE_VERSION 2 // 2 -> 64 bit values, traces of version 1 must be converted again
+#define MAX_TOKENS 5 // max is 5 for RQ with a lifetime hint
+#define MAX_PID_LENGTH 255
 
-// Converts a string to lowercase
-void lowercase(char *s) {
-    // source for tolower() : https://www.geeksforgeeks.org/tolower-function-in-c/
+typedef struct {
+    char magic[8];           // TRACE_MAGIC without NUL
+    unsigned int version;    // TRACE_VERSION
+    unsigned int pidCount;   // number of distinct PIDs
+    unsigned long long pidBytes; // size of the PID string table
+    unsigned long long opCount;  // number of operations
+} TraceHeader;
 
-    for (int i = 0; s[i]; i++) {
-        s[i] = tolower(s[i]);
+typedef enum { TRACE_RQ = 'q', TRACE_RL = 'l', TRACE_RL_AT = 'r', TRACE_RS = 'z', TRACE_COMPACT = 'c', TRACE_AUTOC = 'a', TRACE_SOA = 's', TRACE_FAST = 'f', TRACE_CONSOLIDATE = 'o', TRACE_SAVE = 'v', TRACE_LOAD = 'd', TRACE_RQB = 'b', TRACE_RQB_ITEM = 'i', TRACE_EXIT = 'x' } TraceCommand;
+
+typedef struct {
+    unsigned char command; // TraceCommand
+    char strategy;         // RQ strategy flag -> 0 lets RS pick the strategy of the engine
+    unsigned char lifetime; // AllocSimLifetime of RQ -> traces without hints have 0, which is SHORT
+    unsigned char unused;  // padding -> keeps records 16 bytes
+    unsigned int pid;      // index into PID string table for RQ, RL, RS and RQB items, file name of SAVE and LOAD
+    long long value;       // bytes for RQ, RS, RQB items and C, address for RL @, 1 or 0 for AUTOC, SOA and FAST, items of RQB
+} TraceOp;
+
+// checks if a trace command names a process or a snapshot file -> the name is kept in the PID string table
+bool commandHasName(int command){
+    return command == TRACE_RQ || command == TRACE_RL || command == TRACE_RS || command == TRACE_RQB_ITEM ||
+           command == TRACE_SAVE || command == TRACE_LOAD;
+}
+
+// name of a trace command in profiles
+const char *traceCommandName(int command){
+    switch (command) {
+        case TRACE_RQ: return "rq";
+        case TRACE_RQB: return "rqb";
+        case TRACE_RL: return "rl";
+        case TRACE_RL_AT: return "rl_at";
+        case TRACE_RS: return "rs";
+        case TRACE_COMPACT: return "c";
+        case TRACE_AUTOC: return "autoc";
+        case TRACE_SOA: return "soa";
+        case TRACE_FAST: return "fast";
+        case TRACE_CONSOLIDATE: return "consolidate";
+        case TRACE_SAVE: return "save";
+        case TRACE_LOAD: return "load";
+        default: return "exit";
     }
-    
 }
 
-// *************************************************************************************
+// offset of the first TraceOp -> ops start 8 byte aligned so value can be read in place
+size_t traceOpsOffset(unsigned long long pidBytes){ return (sizeof(TraceHeader) + pidBytes + 7) & ~(size_t) 7; }
+
+typedef struct {
+    const char *start; // first character of token inside the script
+    int length;        // number of characters
+} Token;
+
+typedef struct {
+    const char *data; // whole file contents
+    size_t size;      // number of bytes
+    void *mapping;    // mmap'd region -> NULL if data was read into a malloc'd buffer
+} ScriptFile;
+
+// maps a file read only -> falls back to reading it when it can't be mapped
+bool openScriptFile(const char *fileName, ScriptFile *file){
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        close(fd);
+        return false;
+    }
 
+    file->size = info.st_size;
+    file->mapping = NULL;
+    if (file->size > 0) file->mapping = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (file->mapping == MAP_FAILED || file->mapping == NULL) { // empty file or not mappable
+        file->mapping = NULL;
+        char *buffer = (char *) malloc(file->size + 1);
+        size_t done = 0;
+        ssize_t got;
+        while (done < file->size && (got = read(fd, buffer + done, file->size - done)) > 0) done += got;
+        file->size = done;
+        file->data = buffer;
+    } else {
+        madvise(file->mapping, file->size, MADV_SEQUENTIAL); // scripts are read front to back once
+        file->data = (const char *) file->mapping;
+    }
 
+    close(fd);
+    return true;
+}
 
-void allocate(char* PID, int size, char *type){
+void closeScriptFile(ScriptFile *file){
+    if (file->mapping != NULL) munmap(file->mapping, file->size);
+    else free((void *) file->data);
+}
 
-/* TODO*/
+bool isSeparator(char c){ return c == ' ' || c == '\t' || c == '\r'; }
 
-/*
-allocates memory from a hole to a process based on the algorithm chosen.
-Type = 'F' or 'f' for first fit, 'B' or 'b' for best fit, 'W' or 'w' for worst fit.
-*/
-    // argument validation
-    if (pidExists(PID)){ // check if there is already a process with given PID
-        printError("ERROR: Given PID already exists!");
-        return; // we can't allow PID duplicates because it would corrupt allocation logic
+// reads the token starting at or after *line and moves *line past it -> false if only separators are left
+bool nextToken(const char **line, const char *end, Token *token){
+    while (*line < end && isSeparator(**line)) (*line)++; // skip separators
+    if (*line == end) return false;
+
+    token->start = *line;
+    while (*line < end && !isSeparator(**line)) (*line)++;
+    token->length = *line - token->start;
+    return true;
+}
+
+// splits the line [line, end) into tokens without copying -> returns the number of tokens in the line
+int tokenizeLine(const char *line, const char *end, Token *tokens){
+    int count = 0;
+    Token token;
+
+    while (nextToken(&line, end, &token)) {
+        if (count < MAX_TOKENS) tokens[count] = token;
+        count++;
     }
+    return count;
+}
 
-    if (size <= 0) {
-        printError("ERROR: Invalid memory request size.");
-        return;
+// case insensitive compare of token with a lowercase word
+bool tokenIs(Token token, const char *word){
+    for (int i = 0; i < token.length; i++) {
+        if (word[i] == '\0' || tolower((unsigned char) token.start[i]) != word[i]) return false;
     }
+    return word[token.length] == '\0';
+}
 
-    char flag = tolower(type[0]); // make strategy flag case-insensitive
-    if (flag != 'f' && flag != 'b' && flag != 'w') {
-        printError("ERROR: Invalid allocation strategy, must be F, B, or W.");
-        return;
+// parses a whole token as a number -> optional sign and digits only, false on any other character or overflow
+bool tokenToLong(Token token, long *value){
+    int i = 0;
+    bool negative = false;
+    unsigned long magnitude = 0;
+
+    if (i < token.length && (token.start[i] == '-' || token.start[i] == '+')) {
+        negative = token.start[i] == '-';
+        i++;
     }
-    
+    if (i == token.length) return false; // no digits
 
-    Block *current = memory.head; // current pointer to head
+    for (; i < token.length; i++) {
+        if (!isdigit((unsigned char) token.start[i])) return false;
+        unsigned long digit = token.start[i] - '0';
+        if (magnitude > ((unsigned long) LONG_MAX + 1 - digit) / 10) return false; // would not fit in long
+        magnitude = magnitude * 10 + digit;
+    }
+    if (!negative && magnitude > (unsigned long) LONG_MAX) return false;
 
-    if (flag == 'f') {
-        // First-fit logic
+    *value = negative ? (long) (0 - magnitude) : (long) magnitude;
+    return true;
+}
 
-        while (current != NULL) { // loop through linked list
-            if (isHole(current) && hasEnoughSpace(current, size) ){
-                // this block is allocatable
-                if (current->limit == size){ // size is equal, no fragmentation 
-                    strcpy(current->PID, PID); // just change name of current block
-                }
-                else{ // current->limit > size
-                    Block *newProcess = createBlock(PID, current->base, size); // create memory block for new process
-
-                    // insert new process block before current block
-                    newProcess->prev = current->prev;
-                    newProcess->next = current;
-                    if (current->prev == NULL) {
-                        memory.head = newProcess; // inserting at head
-                    } else {
-                        current->prev->next = newProcess; // inserting in middle
-                    }
-                    current->prev = newProcess;
-
-                    // update current block's base and limit 
-                    current->base += size;
-                    current->limit -= size;
-                }
-                
-                return;
+// parses a command line argument with strtol -> false unless the whole string is a number that fits in long
+bool parseLong(const char *text, long *value){
+    char *end;
+    errno = 0;
+    *value = strtol(text, &end, 10);
+    return end != text && *end == '\0' && errno == 0;
+}
+
+// copies a token into a NUL terminated buffer of MAX_PID_LENGTH + 1 bytes
+char *tokenToString(Token token, char *buffer){
+    int length = token.length < MAX_PID_LENGTH ? token.length : MAX_PID_LENGTH;
+    memcpy(buffer, token.start, length);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+// turns a script line into a trace operation -> false if scripted mode ignores the line
+bool parseCommand(Token *tokens, int tokenCount, TraceOp *op, Token *pid){
+    if (tokenCount == 0) return false; // empty input = do nothing
+
+    long value = 0;
+    op->strategy = 0;
+    op->lifetime = ALLOCSIM_LIFETIME_SHORT;
+    op->value = 0;
+
+    // make commands case insensitive, i.e. should accept rq,RQ,rl,RL,stat,STAT,c,C,exit,EXIT
+    switch (tolower((unsigned char) tokens[0].start[0])) {
+        case 'r':
+            // RQ (Request Memory / allocate): Needs 4 arguments, optional 5th argument is the lifetime hint SHORT or LONG
+            if (tokenIs(tokens[0], "rq") && (tokenCount == 4 || tokenCount == 5)) {
+                if (!tokenToLong(tokens[2], &value)) return false; // invalid size does nothing in scripted mode
+                op->command = TRACE_RQ;
+                *pid = tokens[1];
+                op->value = value;
+                op->strategy = tokens[3].start[0];
+                op->lifetime = ALLOCSIM_LIFETIME_SHORT;
+                if (tokenCount == 5 && tokenIs(tokens[4], "long")) op->lifetime = ALLOCSIM_LIFETIME_LONG;
+                else if (tokenCount == 5 && !tokenIs(tokens[4], "short")) return false; // invalid hint does nothing in scripted mode
+                return true;
             }
-            
-            // update current pointer after each loop
-            current = current->next;
-        }
+            // RQB (Batch request): Needs a strategy and at least one PID:Bytes item -> items are read by readBatchLine
+            if (tokenIs(tokens[0], "rqb") && tokenCount >= 3) {
+                op->command = TRACE_RQB;
+                op->strategy = tokens[1].start[0];
+                op->value = tokenCount - 2;
+                return true;
+            }
+            // RL (Release Memory / Deallocate): Needs 2 arguments, RL @address releases by address
+            if (tokenIs(tokens[0], "rl") && tokenCount == 2 && tokens[1].start[0] == '@') {
+                Token address = { tokens[1].start + 1, tokens[1].length - 1 };
+                if (!tokenToLong(address, &value)) return false;
+                op->command = TRACE_RL_AT;
+                op->value = value;
+                return true;
+            }
+            if (tokenIs(tokens[0], "rl") && tokenCount == 2) {
+                op->command = TRACE_RL;
+                *pid = tokens[1];
+                return true;
+            }
+            // RS (Resize): Needs 3 arguments, optional 4th argument is the strategy used if the process has to move
+            if (tokenIs(tokens[0], "rs") && (tokenCount == 3 || tokenCount == 4)) {
+                if (!tokenToLong(tokens[2], &value)) return false;
+                op->command = TRACE_RS;
+                *pid = tokens[1];
+                op->value = value;
+                if (tokenCount == 4) op->strategy = tokens[3].start[0];
+                return true;
+            }
+            return false;
+        case 'c':
+            // C (Compact): Needs 1 argument, optional 2nd argument is the hole size to stop at
+            if (tokenIs(tokens[0], "c") && (tokenCount == 1 || tokenCount == 2)) {
+                if (tokenCount == 2 && !tokenToLong(tokens[1], &value)) return false;
+                op->command = TRACE_COMPACT;
+                op->value = value;
+                return true;
+            }
+            // CONSOLIDATE (Merge quick lists): Needs 1 argument
+            if (tokenIs(tokens[0], "consolidate") && tokenCount == 1) {
+                op->command = TRACE_CONSOLIDATE;
+                return true;
+            }
+            return false;
+        case 'a':
+            // AUTOC (Compact on failure): Needs 2 arguments
+            if (tokenIs(tokens[0], "autoc") && tokenCount == 2) {
+                op->command = TRACE_AUTOC;
+                if (tokenIs(tokens[1], "on")) op->value = 1;
+                else if (tokenIs(tokens[1], "off")) op->value = 0;
+                else return false; // invalid mode does nothing in scripted mode
+                return true;
+            }
+            return false;
+        case 's':
+            // SOA (Block table): Needs 2 arguments
+            if (tokenIs(tokens[0], "soa") && tokenCount == 2) {
+                op->command = TRACE_SOA;
+                if (tokenIs(tokens[1], "on")) op->value = 1;
+                else if (tokenIs(tokens[1], "off")) op->value = 0;
+                else return false; // invalid mode does nothing in scripted mode
+                return true;
+            }
+            // SAVE (Snapshot to file): Needs 2 arguments
+            if (tokenIs(tokens[0], "save") && tokenCount == 2) {
+                op->command = TRACE_SAVE;
+                *pid = tokens[1];
+                return true;
+            }
+            return false; // STAT and STATS are ignored
+        case 'f':
+            // FAST (Quick lists): Needs 2 arguments
+            if (tokenIs(tokens[0], "fast") && tokenCount == 2) {
+                op->command = TRACE_FAST;
+                if (tokenIs(tokens[1], "on")) op->value = 1;
+                else if (tokenIs(tokens[1], "off")) op->value = 0;
+                else return false; // invalid mode does nothing in scripted mode
+                return true;
+            }
+            return false;
+        case 'l':
+            // LOAD (Snapshot from file): Needs 2 arguments
+            if (tokenIs(tokens[0], "load") && tokenCount == 2) {
+                op->command = TRACE_LOAD;
+                *pid = tokens[1];
+                return true;
+            }
+            return false;
+        case 'e':
+            // EXIT: Needs 1 argument
+            if (tokenIs(tokens[0], "exit") && tokenCount == 1) {
+                op->command = TRACE_EXIT;
+                return true;
+            }
+            return false;
+        default:
+            return false; // unknown commands are ignored
+    }
+}
 
-        printError("ERROR: Insufficient memory to allocate to the request.");
-        return;
+// runs one operation -> false if the script should stop
+bool executeOp(Memory *memory, TraceOp *op, char *PID, long *failed){
+    char type[2] = { op->strategy, '\0' };
 
-    } else { // Best-fit & Worst-fit logic
+    switch (op->command) {
+        case TRACE_RQ:
+            if (!allocateHinted(memory, PID, op->value, type, op->lifetime == ALLOCSIM_LIFETIME_LONG) && failed != NULL) (*failed)++;
+            return true;
+        case TRACE_RL: deallocate(memory, PID); return true;
+        case TRACE_RL_AT: deallocateAt(memory, op->value); return true;
+        case TRACE_RS: reallocate(memory, PID, op->value, op->strategy != 0 ? type : NULL); return true;
+        case TRACE_COMPACT: compact(memory, op->value); return true;
+        case TRACE_AUTOC: allocsim_set_compact_on_failure(memory, op->value != 0); return true;
+        case TRACE_SOA: setBlockTable(memory, op->value ? true : false); return true;
+        case TRACE_FAST: setQuickLists(memory, op->value ? true : false); return true;
+        case TRACE_CONSOLIDATE: consolidate(memory); return true;
+        case TRACE_SAVE: saveMemory(memory, PID); return true;
+        case TRACE_LOAD: loadMemory(memory, PID); return true;
+        case TRACE_RQB: case TRACE_RQB_ITEM: return true; // batches are gathered and run by runBatch
+        default: return false; // TRACE_EXIT
+    }
+}
 
-        Block *bestFit = NULL; // for best-fit logic
-        Block *worstFit = NULL; // for worst-fit logic
-        int bestFitSize = memory.total_memory; // possible max size
-        int worstFitSize = -1;
+// items of an RQB command -> kept between batches so their arrays are only grown, never reallocated per batch
+typedef struct {
+    char (*names)[MAX_PID_LENGTH + 1]; // PID of every item
+    char **PIDs;                       // names[i] -> filled in by runBatch
+    long *sizes;
+    long count;
+    long capacity;
+} Batch;
+
+void batchAdd(Batch *batch, Token PID, long size){
+    if (batch->count == batch->capacity) {
+        batch->capacity = batch->capacity ? batch->capacity * 2 : 64;
+        batch->names = realloc(batch->names, batch->capacity * sizeof(*batch->names));
+        batch->PIDs = (char **) realloc(batch->PIDs, batch->capacity * sizeof(char *));
+        batch->sizes = (long *) realloc(batch->sizes, batch->capacity * sizeof(long));
+    }
+    tokenToString(PID, batch->names[batch->count]);
+    batch->sizes[batch->count++] = size;
+}
 
-        while (current != NULL) { // loop through linked list
-            if (isHole(current) && hasEnoughSpace(current, size) ){
-                // this block is allocatable
-                if (current->limit < bestFitSize){ // check if current is the smallest hole we have found -> for best-fit logic
-                    bestFit = current; // save current as best fit block
-                    bestFitSize = current->limit; // update bestFitSize
-                }
-                if (current->limit > worstFitSize){ // check if current is the biggest hole we have found -> for worst-fit logic
-                    worstFit = current; // save current as worst fit block
-                    worstFitSize = current->limit; // update worstFitSize
-                }
-            }
+void freeBatch(Batch *batch){
+    free(batch->names);
+    free(batch->PIDs);
+    free(batch->sizes);
+}
 
-            // update current pointer after each loop
-            current = current->next;
-        }
+// splits a PID:Bytes item at its last colon -> false if the PID is empty or Bytes is not a number
+bool parseBatchItem(Token item, Token *PID, long *size){
+    int colon = item.length - 1;
+    while (colon >= 0 && item.start[colon] != ':') colon--;
+    if (colon <= 0) return false;
 
-        // after looping through whole memory is finished, we insert new block
-        Block *target = NULL;
-        if (flag == 'b') target = bestFit; // for best-fit logic
-        else if (flag == 'w') target = worstFit; // for worst-fit logic
+    Token bytes = { item.start + colon + 1, item.length - colon - 1 };
+    PID->start = item.start;
+    PID->length = colon;
+    return tokenToLong(bytes, size);
+}
 
-        if (target == NULL) {
-            printError("ERROR: Insufficient memory to allocate to the request.");
+// reads every PID:Bytes item of an RQB line into batch -> items that don't parse are ignored like other bad script lines
+void readBatchLine(const char *line, const char *end, Batch *batch){
+    Token token, PID;
+    long size;
+    int index = 0;
+
+    batch->count = 0;
+    while (nextToken(&line, end, &token)) {
+        if (index++ < 2) continue; // RQB and the strategy
+        if (parseBatchItem(token, &PID, &size)) batchAdd(batch, PID, size);
+    }
+}
+
+// places the gathered items with one RQB -> failed counts the requests that were not placed
+void runBatch(Memory *memory, Batch *batch, char strategy, long *failed){
+    if (batch->count == 0) return;
+
+    char type[2] = { strategy, '\0' };
+    for (long i = 0; i < batch->count; i++) batch->PIDs[i] = batch->names[i];
+    long placed = allocateBatch(memory, batch->PIDs, batch->sizes, batch->count, type);
+    if (failed != NULL) *failed += batch->count - placed;
+    batch->count = 0;
+}
+
+// RQB from the interactive prompt -> nothing is requested if an item is not PID:Bytes
+void requestBatch(Memory *memory, char *type, char **items, int count){
+    Batch batch;
+    memset(&batch, 0, sizeof(batch));
+    Token PID;
+    long size;
+
+    for (int i = 0; i < count; i++) {
+        Token item = { items[i], (int) strlen(items[i]) };
+        if (!parseBatchItem(item, &PID, &size)) {
+            printError(memory, "ERROR: Batch items must be PID:Bytes.");
+            freeBatch(&batch);
             return;
         }
+        batchAdd(&batch, PID, size);
+    }
+    runBatch(memory, &batch, type[0], NULL);
+    freeBatch(&batch);
+}
 
-        if (target->limit == size){ // limit = size, no fragmentation 
-            strcpy(target->PID, PID); // just change name of target block
+// replays a text script line by line straight from the mapped file
+void runTextScript(Memory *memory, ScriptFile *file){
+    const char *line = file->data;
+    const char *end = file->data + file->size;
+    char pidBuffer[MAX_PID_LENGTH + 1];
+    Batch batch;
+    memset(&batch, 0, sizeof(batch));
+
+    while (line < end) {
+        const char *lineEnd = memchr(line, '\n', end - line);
+        if (lineEnd == NULL) lineEnd = end; // last line without newline
+
+        Token tokens[MAX_TOKENS];
+        Token pid;
+        TraceOp op;
+        int tokenCount = tokenizeLine(line, lineEnd, tokens);
+
+        if (parseCommand(tokens, tokenCount, &op, &pid)) {
+            PROFILE_START(started);
+            if (op.command == TRACE_RQB) {
+                readBatchLine(line, lineEnd, &batch);
+                runBatch(memory, &batch, op.strategy, NULL);
+            }
+            char *PID = commandHasName(op.command) ? tokenToString(pid, pidBuffer) : NULL;
+            bool running = executeOp(memory, &op, PID, NULL);
+            PROFILE_COMMAND(memory, traceCommandName(op.command), started);
+            if (!running) break;
         }
-        else{ // limit > size
-            Block *newProcess = createBlock(PID, target->base, size); // create memory block for new process
 
-            // insert new process block before target block
-            newProcess->prev = target->prev;
-            newProcess->next = target;
-            if (target->prev == NULL) {
-                memory.head = newProcess; // inserting at head
-            } else {
-                target->prev->next = newProcess; // inserting in middle
-            }
-            target->prev = newProcess;
+        line = lineEnd + 1;
+    }
+    freeBatch(&batch);
+}
+
+// returns the header if the file is a binary trace with consistent sizes -> NULL otherwise
+const TraceHeader *traceHeader(ScriptFile *file){
+    if (file->size < sizeof(TraceHeader) || memcmp(file->data, TRACE_MAGIC, 8) != 0) return NULL;
+
+    const TraceHeader *header = (const TraceHeader *) file->data;
+    size_t opsOffset = traceOpsOffset(header->pidBytes);
+    if (header->version != TRACE_VERSION || header->pidBytes > file->size ||
+        opsOffset + header->opCount * sizeof(TraceOp) != file->size) return NULL;
+
+    return header;
+}
+
+// a whole script in memory -> parsed once, replayed as often as needed
+typedef struct {
+    ScriptFile file;          // binary traces stay mapped, ops and PIDs point into it
+    const TraceOp *ops;       // operations in script order
+    unsigned long long opCount;
+    char **pids;              // PID string of every PID id
+    unsigned int pidCount;
+    const char *pidStrings;   // NUL terminated PIDs back to back
+    unsigned long long pidBytes;
+    PidInterner interner;     // owns PID strings of text scripts
+    TraceOp *parsedOps;       // owns ops of text scripts -> NULL for binary traces
+} Trace;
+
+// finds the start of every PID string -> false if the string table is cut
+bool indexTracePIDs(Trace *trace){
+    trace->pids = (char **) malloc(sizeof(char *) * (trace->pidCount + 1));
+    size_t offset = 0;
+    for (unsigned int i = 0; i < trace->pidCount; i++) {
+        if (offset >= trace->pidBytes) return false;
+        trace->pids[i] = (char *) trace->pidStrings + offset;
+        offset += strnlen(trace->pidStrings + offset, trace->pidBytes - offset) + 1;
+    }
+    return offset <= trace->pidBytes;
+}
+
+// adds an op parsed from a text script -> grows parsedOps as needed
+void appendOp(Trace *trace, size_t *opCapacity, const TraceOp *op){
+    if (trace->opCount == *opCapacity) {
+        *opCapacity *= 2;
+        trace->parsedOps = (TraceOp *) realloc(trace->parsedOps, *opCapacity * sizeof(TraceOp));
+    }
+    trace->parsedOps[trace->opCount++] = *op;
+}
+
+// loads a text script or binary trace -> false if the file can't be opened or the trace is corrupt
+bool loadTrace(const char *fileName, Trace *trace){
+    memset(trace, 0, sizeof(Trace));
+    if (!openScriptFile(fileName, &trace->file)) return false;
+
+    const TraceHeader *header = traceHeader(&trace->file);
+    if (header != NULL) { // binary trace -> nothing is copied
+        trace->pidStrings = trace->file.data + sizeof(TraceHeader);
+        trace->pidBytes = header->pidBytes;
+        trace->pidCount = header->pidCount;
+        trace->ops = (const TraceOp *) (trace->file.data + traceOpsOffset(header->pidBytes));
+        trace->opCount = header->opCount;
+        return indexTracePIDs(trace);
+    }
 
-            // update target block's base and limit 
-            target->base += size;
-            target->limit -= size;
+    // text script -> tokenize every line once
+    size_t opCapacity = 1024;
+    trace->parsedOps = (TraceOp *) malloc(opCapacity * sizeof(TraceOp));
+    char pidBuffer[MAX_PID_LENGTH + 1];
+    Batch batch;
+    memset(&batch, 0, sizeof(batch));
+
+    const char *line = trace->file.data;
+    const char *end = trace->file.data + trace->file.size;
+    while (line < end) {
+        const char *lineEnd = memchr(line, '\n', end - line);
+        if (lineEnd == NULL) lineEnd = end;
+
+        Token tokens[MAX_TOKENS];
+        Token pid;
+        TraceOp op;
+        memset(&op, 0, sizeof(TraceOp));
+        int tokenCount = tokenizeLine(line, lineEnd, tokens);
+
+        if (parseCommand(tokens, tokenCount, &op, &pid)) {
+            if (op.command == TRACE_RQB) { // one op with the item count, then one op per item
+                readBatchLine(line, lineEnd, &batch);
+                op.value = batch.count;
+            }
+            if (commandHasName(op.command)) op.pid = internPID(&trace->interner, tokenToString(pid, pidBuffer));
+            appendOp(trace, &opCapacity, &op);
+
+            for (long i = 0; op.command == TRACE_RQB && i < batch.count; i++) {
+                TraceOp item;
+                memset(&item, 0, sizeof(TraceOp));
+                item.command = TRACE_RQB_ITEM;
+                item.pid = internPID(&trace->interner, batch.names[i]);
+                item.value = batch.sizes[i];
+                appendOp(trace, &opCapacity, &item);
+            }
         }
+        line = lineEnd + 1;
+    }
+    freeBatch(&batch);
 
-        return;
+    trace->ops = trace->parsedOps;
+    trace->pidStrings = trace->interner.strings;
+    trace->pidBytes = trace->interner.used;
+    trace->pidCount = trace->interner.count;
+    return indexTracePIDs(trace);
+}
+
+void freeTrace(Trace *trace){
+    free(trace->pids);
+    free(trace->parsedOps);
+    freeInterner(&trace->interner);
+    closeScriptFile(&trace->file);
+}
+
+// replays a loaded trace -> strategy overrides the strategy flag of every RQ and RS unless it is 0
+void replayTrace(Memory *memory, Trace *trace, char strategy, long *failed){
+    Batch batch;
+    memset(&batch, 0, sizeof(batch));
+
+    for (unsigned long long i = 0; i < trace->opCount; i++) {
+        TraceOp op = trace->ops[i];
+        PROFILE_START(started);
+        if (op.command == TRACE_RQB) { // gather the items that follow
+            while (i + 1 < trace->opCount && trace->ops[i + 1].command == TRACE_RQB_ITEM) {
+                const TraceOp *item = &trace->ops[++i];
+                if (item->pid >= trace->pidCount) continue; // corrupt record
+                Token PID = { trace->pids[item->pid], (int) strlen(trace->pids[item->pid]) };
+                batchAdd(&batch, PID, item->value);
+            }
+            runBatch(memory, &batch, strategy != 0 ? strategy : op.strategy, failed);
+            PROFILE_COMMAND(memory, traceCommandName(op.command), started);
+            continue;
+        }
+        char *PID = NULL;
+        if (commandHasName(op.command)) {
+            if (op.pid >= trace->pidCount) continue; // corrupt record
+            PID = trace->pids[op.pid];
+        }
+        if (strategy != 0 && (op.command == TRACE_RQ || op.command == TRACE_RS)) op.strategy = strategy;
+        bool running = executeOp(memory, &op, PID, failed);
+        PROFILE_COMMAND(memory, traceCommandName(op.command), started);
+        if (!running) break;
     }
+    freeBatch(&batch);
 }
 
+// runs a script file in scripted mode -> false if file can't be opened
+bool runScript(Memory *memory, const char *fileName){
+    ScriptFile file;
+    if (!openScriptFile(fileName, &file)) return false;
 
-void deallocate(char* PID){
+    bool binary = traceHeader(&file) != NULL;
+    if (!binary) runTextScript(memory, &file); // text scripts are streamed without building a trace
+    closeScriptFile(&file);
+    if (!binary) return true;
 
-/* TODO*/
+    Trace trace;
+    if (loadTrace(fileName, &trace)) replayTrace(memory, &trace, 0, NULL);
+    freeTrace(&trace);
+    return true;
+}
 
-/*
-Deallocates memory from a process to a hole.
-If the hole is adjacent to another hole, the two holes should be merged.
-*/
-    // argument validation
-    if (strcmp(PID, HOLE_PID) == 0) {
-        printError("ERROR: Can not deallocate a hole.");
-        return;
+// converts a text script to a binary trace -> false if a file can't be opened or written
+bool convertScript(const char *scriptName, const char *traceName){
+    Trace trace;
+    if (!loadTrace(scriptName, &trace)) {
+        freeTrace(&trace);
+        return false;
     }
-    
 
-    Block *current = memory.head; // current pointer to head
+    FILE *out = fopen(traceName, "wb");
+    if (out == NULL) {
+        freeTrace(&trace);
+        return false;
+    }
 
-    while (current != NULL) { // loop through linked list
-        // edge case start and end
-        if (!isHole(current) && strcmp(current->PID, PID) == 0){ // find the block with given PID
-            // deallocate current block by turning it to a hole
-            strcpy(current->PID, HOLE_PID);
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, 8);
+    header.version = TRACE_VERSION;
+    header.pidCount = trace.pidCount;
+    header.pidBytes = trace.pidBytes;
+    header.opCount = trace.opCount;
+
+    static const char padding[8] = { 0 };
+    size_t paddingBytes = traceOpsOffset(trace.pidBytes) - sizeof(TraceHeader) - trace.pidBytes;
+    bool ok = fwrite(&header, sizeof(TraceHeader), 1, out) == 1 &&
+              fwrite(trace.pidStrings, 1, trace.pidBytes, out) == trace.pidBytes &&
+              fwrite(padding, 1, paddingBytes, out) == paddingBytes &&
+              fwrite(trace.ops, sizeof(TraceOp), trace.opCount, out) == trace.opCount;
+    ok = (fclose(out) == 0) && ok;
+
+    freeTrace(&trace);
+    return ok;
+}
 
-            // if prev and next are holes, current will be merged into one large block with prev and next
+// *************************************************************************************
 
-            // check if next block is hole -> for merging
-            if (current->next != NULL && isHole(current->next)){ // check if current is not last node AND next block is hole
-                Block *next = current->next; // get a pointer to next block
-                current->limit += next->limit; // elongate current block's limit with next block's limit to merge
-                current->next = next->next; // update merged current block's next pointer to block after next block or NULL if next block was last node
-                
-                if (next->next != NULL){ // check if next block is not last node
-                    next->next->prev = current; // update block after next block's prev pointer to point to merged current block
-                }
-                free(next); // dealloc memory block next points to -> remove next block since its already merged with current block
-            }
 
 
-            // check if previous block is hole -> for merging
-            if (current->prev != NULL && isHole(current->prev)){ // check if current is not head node AND next prev is hole
-                Block *previous = current->prev; // get a pointer to previous block
-                previous->limit += current->limit; // elongate previous block's limit with current block's limit to merge
-                previous->next = current->next; // update merged previous block's next pointer to block after current block
-                
-                if (current->next != NULL){ // check if current block is not last node
-                    current->next->prev = previous; // update next block's prev pointer to point to merged (previous+current) block
-                }
-                free(current); // dealloc memory at current block -> remove current block since its already merged with previous block
+
+// *************************************** SWEEP ***************************************
+// replays one parsed trace against independent memories, one per (strategy, memory size) pair, on several threads
+
+typedef struct {
+    char strategy;        // strategy flag forced on every RQ
+    long total_memory;    // memory size of this run
+    long failed;          // RQs that could not be placed
+    double milliseconds;  // replay time
+    int holeCount;        // holes left at the end
+    long freeBytes;       // free bytes left at the end
+    long largest;         // biggest hole left at the end
+    long compactedBytes;  // bytes moved by compactions
+    long internalFragmentation;
+} SweepRun;
+
+typedef struct {
+    Trace *trace;         // shared read only by every thread
+    SweepRun *runs;
+    int runCount;
+    int nextRun;          // index of the next run nobody took yet
+    pthread_mutex_t lock; // protects nextRun
+} Sweep;
+
+void *sweepWorker(void *argument){
+    Sweep *sweep = (Sweep *) argument;
+
+    while (1) {
+        pthread_mutex_lock(&sweep->lock);
+        int i = sweep->nextRun++;
+        pthread_mutex_unlock(&sweep->lock);
+        if (i >= sweep->runCount) return NULL;
+
+        SweepRun *run = &sweep->runs[i];
+        Memory *memory = createMemory(run->total_memory, true); // every run owns its memory
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        replayTrace(memory, sweep->trace, run->strategy, &run->failed);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        run->milliseconds = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+        AllocSimStats stats;
+        allocsim_stats(memory, &stats);
+        run->holeCount = stats.holes;
+        run->freeBytes = stats.freeBytes;
+        run->largest = stats.largestHole;
+        run->compactedBytes = stats.compactedBytes;
+        run->internalFragmentation = stats.internalFragmentation;
+        destroyMemory(memory);
+    }
+}
+
+// runs every strategy of strategies on every size of the comma separated sizes -> false on bad arguments
+bool runSweep(const char *fileName, const char *strategies, char *sizes, int threads){
+    Trace trace;
+    if (!loadTrace(fileName, &trace)) {
+        freeTrace(&trace);
+        printError(NULL, "ERROR: Could not open script file.");
+        return false;
+    }
+
+    // runs share the trace on several threads -> SAVE would write one file from all of them and LOAD would swap the memory size mid run
+    for (unsigned long long i = 0; i < trace.opCount; i++) {
+        if (trace.ops[i].command == TRACE_SAVE || trace.ops[i].command == TRACE_LOAD) {
+            printError(NULL, "ERROR: Sweep scripts can't contain SAVE or LOAD.");
+            freeTrace(&trace);
+            return false;
+        }
+    }
+
+    // one run per (strategy, size) pair
+    int sizeCount = 1;
+    for (int i = 0; sizes[i]; i++) if (sizes[i] == ',') sizeCount++;
+
+    Sweep sweep;
+    sweep.trace = &trace;
+    sweep.runs = (SweepRun *) calloc(strlen(strategies) * sizeCount, sizeof(SweepRun));
+    sweep.runCount = 0;
+    sweep.nextRun = 0;
+    pthread_mutex_init(&sweep.lock, NULL);
+
+    for (int i = 0; strategies[i]; i++) {
+        char *size = sizes;
+        for (int j = 0; j < sizeCount; j++) {
+            char *end;
+            errno = 0;
+            long total_memory = strtol(size, &end, 10);
+            if (end == size || (*end != ',' && *end != '\0') || errno != 0 || total_memory <= 0) {
+                printError(NULL, "ERROR: Sweep memory sizes must be positive.");
+                free(sweep.runs);
+                freeTrace(&trace);
+                return false;
             }
+            sweep.runs[sweep.runCount].strategy = strategies[i];
+            sweep.runs[sweep.runCount].total_memory = total_memory;
+            sweep.runCount++;
 
-            return; // deallocate done
-        
+            char *comma = strchr(size, ',');
+            if (comma != NULL) size = comma + 1;
         }
+    }
 
-        // update current pointer
-        current = current->next;
+    if (threads > sweep.runCount) threads = sweep.runCount;
+    pthread_t *workers = (pthread_t *) malloc(sizeof(pthread_t) * threads);
+    for (int i = 0; i < threads; i++) pthread_create(&workers[i], NULL, sweepWorker, &sweep);
+    for (int i = 0; i < threads; i++) pthread_join(workers[i], NULL);
+
+    printf("Sweep of %llu operations, %d runs on %d threads\n", trace.opCount, sweep.runCount, threads);
+    printf("%-8s %12s %10s %10s %8s %12s %12s %10s %14s %10s\n", "strategy", "memory", "failed", "time ms",
+           "holes", "free", "largest", "ext.frag", "compacted", "int.frag");
+    for (int i = 0; i < sweep.runCount; i++) {
+        SweepRun *run = &sweep.runs[i];
+        double external = run->freeBytes > 0 ? 100.0 * (run->freeBytes - run->largest) / run->freeBytes : 0.0;
+        printf("%-8c %12ld %10ld %10.2f %8d %12ld %12ld %9.2f%% %14ld %10ld\n", run->strategy, run->total_memory,
+               run->failed, run->milliseconds, run->holeCount, run->freeBytes, run->largest, external,
+               run->compactedBytes, run->internalFragmentation);
     }
-    // else -> PID was not found
-    printError("ERROR: Given PID does not exist in memory.");
+
+    pthread_mutex_destroy(&sweep.lock);
+    free(workers);
+    free(sweep.runs);
+    freeTrace(&trace);
+    return true;
 }
 
+// *************************************************************************************
 
-void status(){
 
-/* TODO*/
 
-/*
-Print the status of the memory manager.
-Includes each hole / process address, the amount of free memory, and the amount of allocated memory; ordered by starting memory address.
 
-Addresses [0:315000] Process P1
-Addresses [315001: 512500] Process P3
-Addresses [512501:625575] Unused
-Addresses [625575:725100] Process P6
-Addresses [725001] . . .
+// *************************************** SERVER **************************************
+// daemon mode -> clients send RQ/RL/RS/C/STAT lines over a unix domain socket, every line gets one reply line
+// the address space is split into arenas with their own lock, requests fall back to other arenas when one is full
+// a striped PID directory remembers which arena holds each process, so RL and duplicate checks touch one arena
 
-*/
+#define DIRECTORY_STRIPES 64  // independent locks of the PID directory
+#define DIRECTORY_BUCKETS 1024 // hash buckets per stripe
+#define SERVER_LINE 512       // longest accepted command line
 
-    Block *current = memory.head;
+typedef struct {
+    Memory *memory;       // blocks of this arena, addresses start at 0
+    long offset;          // address of the arena inside the whole memory
+    pthread_mutex_t lock; // protects memory
+} Arena;
 
-    while (current != NULL){
-        printBlock(current); // custom print function for blocks
-        current = current->next; // update current pointer
-    }
-    
+typedef struct DirectoryEntry {
+    struct DirectoryEntry *next; // next entry of the same bucket
+    int arena;                   // arena holding the process
+    char PID[];                  // process id name
+} DirectoryEntry;
+
+typedef struct {
+    pthread_mutex_t lock; // held for the whole RQ or RL of a PID of this stripe
+    DirectoryEntry *buckets[DIRECTORY_BUCKETS];
+} DirectoryStripe;
+
+typedef struct {
+    Arena *arenas;
+    int arenaCount;
+    DirectoryStripe *stripes; // DIRECTORY_STRIPES stripes
+    int listener;             // listening socket
+} Server;
+
+DirectoryEntry **directoryFind(DirectoryStripe *stripe, size_t hash, const char *PID){
+    DirectoryEntry **entry = &stripe->buckets[(hash / DIRECTORY_STRIPES) % DIRECTORY_BUCKETS];
+    while (*entry != NULL && strcmp((*entry)->PID, PID) != 0) entry = &(*entry)->next;
+    return entry; // points to the link that holds PID, or to the NULL link at the end of the bucket
 }
 
+// RQ of one client -> home arena is picked by PID hash, then the other arenas are tried in order
+void serverRequest(Server *server, char *PID, long size, char *type, AllocSimLifetime lifetime, char *reply){
+    size_t hash = hashPID(PID);
+    DirectoryStripe *stripe = &server->stripes[hash % DIRECTORY_STRIPES];
 
-void compact(){
+    pthread_mutex_lock(&stripe->lock);
+    DirectoryEntry **link = directoryFind(stripe, hash, PID);
+    if (*link != NULL) {
+        pthread_mutex_unlock(&stripe->lock);
+        sprintf(reply, "ERR %s\n", allocsim_strerror(ALLOCSIM_ERR_PID_EXISTS));
+        return;
+    }
 
-/* TODO*/
+    int home = hash % server->arenaCount;
+    AllocSimResult result = ALLOCSIM_ERR_NO_MEMORY;
+    for (int i = 0; i < server->arenaCount; i++) {
+        Arena *arena = &server->arenas[(home + i) % server->arenaCount];
+        long base = 0;
+
+        pthread_mutex_lock(&arena->lock);
+        result = allocsim_request_hint(arena->memory, PID, size, type[0], lifetime, &base);
+        pthread_mutex_unlock(&arena->lock);
+
+        if (result == ALLOCSIM_OK) {
+            DirectoryEntry *entry = (DirectoryEntry *) malloc(sizeof(DirectoryEntry) + strlen(PID) + 1);
+            strcpy(entry->PID, PID);
+            entry->arena = (home + i) % server->arenaCount;
+            entry->next = NULL;
+            *link = entry;
+            pthread_mutex_unlock(&stripe->lock);
+            sprintf(reply, "OK %ld\n", arena->offset + base);
+            return;
+        }
+        if (result != ALLOCSIM_ERR_NO_MEMORY && result != ALLOCSIM_ERR_ENGINE_BUSY) break; // invalid requests fail the same way in every arena
+    }
 
-/*
-Compacts the memory allocations by shifting all current allocations to the top and combining all holes into a single hole.
-*/
-// shift all memory blocks to top and shift all holes to bottom to form one giant hole
+    pthread_mutex_unlock(&stripe->lock);
+    sprintf(reply, "ERR %s\n", allocsim_strerror(result));
+}
 
-    // initalize new variables to form a new shuffled memory list
-    int base = 0; // to store base value for the blocks I will create while shuffling 
-    int totalHoleSpace = 0; // to store total amount of hole block memory space
-    Block *newHead = NULL; // pointer to new head
-    Block *lastProcess = NULL; // to store pointer to last (non-hole) process block
-    Block *current = memory.head; // current pointer to head
+// RL of one client -> the directory tells which arena to lock
+void serverRelease(Server *server, char *PID, char *reply){
+    size_t hash = hashPID(PID);
+    DirectoryStripe *stripe = &server->stripes[hash % DIRECTORY_STRIPES];
+
+    pthread_mutex_lock(&stripe->lock);
+    DirectoryEntry **link = directoryFind(stripe, hash, PID);
+    DirectoryEntry *entry = *link;
+    if (entry == NULL) {
+        pthread_mutex_unlock(&stripe->lock);
+        sprintf(reply, "ERR %s\n", allocsim_strerror(ALLOCSIM_ERR_PID_NOT_FOUND));
+        return;
+    }
 
-    while (current != NULL) {
-        if (!isHole(current)){  // if current block is not a hole
-            Block *shuffledBlock = createBlock(current->PID, base, current->limit); // create a new block to shuffle the process block
-            base += current->limit; // update base by adding current block's limit
+    Arena *arena = &server->arenas[entry->arena];
+    pthread_mutex_lock(&arena->lock);
+    allocsim_release(arena->memory, PID);
+    pthread_mutex_unlock(&arena->lock);
 
-            // set newHead to first process block found
-            if (newHead == NULL){ 
-                newHead = shuffledBlock;
-            } 
-            else { // for non-first process blocks 
-                shuffledBlock->prev = lastProcess; // set new (shuffled) process block's prev pointer to the last process block
-                lastProcess->next = shuffledBlock; // set last process block's next pointer to the new process block
-            }
+    *link = entry->next;
+    free(entry);
+    pthread_mutex_unlock(&stripe->lock);
+    strcpy(reply, "OK\n");
+}
 
-            // update last process block pointer for the next shuffles
-            lastProcess = shuffledBlock; 
+// RS of one client -> the process is resized inside the arena that holds it
+void serverResize(Server *server, char *PID, long size, char strategy, char *reply){
+    size_t hash = hashPID(PID);
+    DirectoryStripe *stripe = &server->stripes[hash % DIRECTORY_STRIPES];
 
-        } else {  // else, if current block is hole
-            totalHoleSpace += current->limit; // update how much hole space we have
-        }
+    pthread_mutex_lock(&stripe->lock);
+    DirectoryEntry *entry = *directoryFind(stripe, hash, PID);
+    if (entry == NULL) {
+        pthread_mutex_unlock(&stripe->lock);
+        sprintf(reply, "ERR %s\n", allocsim_strerror(ALLOCSIM_ERR_PID_NOT_FOUND));
+        return;
+    }
 
-        // update current pointer to next by also removing current node
-        Block *next = current->next;
-        free(current); // remove current node's block
-        current = next; // update current pointer
+    Arena *arena = &server->arenas[entry->arena];
+    long base = 0;
+    pthread_mutex_lock(&arena->lock);
+    AllocSimResult result = allocsim_resize(arena->memory, PID, size, strategy, &base);
+    pthread_mutex_unlock(&arena->lock);
+    pthread_mutex_unlock(&stripe->lock);
+
+    if (result == ALLOCSIM_OK) sprintf(reply, "OK %ld\n", arena->offset + base);
+    else sprintf(reply, "ERR %s\n", allocsim_strerror(result));
+}
+
+// C compacts arenas one at a time, STAT sums the running counters of every arena
+void serverCompact(Server *server, long targetHole, char *reply){
+    long moved = 0;
+    for (int i = 0; i < server->arenaCount; i++) {
+        pthread_mutex_lock(&server->arenas[i].lock);
+        long bytesMoved = 0;
+        allocsim_compact(server->arenas[i].memory, targetHole, &bytesMoved); // buddy arenas stay as they are
+        moved += bytesMoved;
+        pthread_mutex_unlock(&server->arenas[i].lock);
     }
+    sprintf(reply, "OK moved %ld\n", moved);
+}
 
-    // create one giant hole at bottom
-    if (totalHoleSpace > 0) { // if we had holes
-        Block *giantHole = createBlock(HOLE_PID, base, totalHoleSpace); // create one giant hole block
+void serverStat(Server *server, char *reply){
+    long freeBytes = 0, processes = 0, holes = 0, largest = 0;
+    for (int i = 0; i < server->arenaCount; i++) {
+        AllocSimStats stats;
+        pthread_mutex_lock(&server->arenas[i].lock);
+        allocsim_stats(server->arenas[i].memory, &stats);
+        pthread_mutex_unlock(&server->arenas[i].lock);
+
+        freeBytes += stats.freeBytes;
+        holes += stats.holes;
+        processes += stats.processes;
+        if (stats.largestHole > largest) largest = stats.largestHole;
+    }
+    sprintf(reply, "OK arenas %d processes %ld free %ld holes %ld largest %ld\n", server->arenaCount, processes, freeBytes, holes, largest);
+}
 
-        if (lastProcess != NULL){ // if we had a process block
-            // link last memory block to giant hole block
-            giantHole->prev = lastProcess; 
-            lastProcess->next = giantHole;
-        }
-        else{ // if we didn't had any process 
-            newHead = giantHole; // point new head to giant hole block
+// answers one command line -> false if the client asked to quit
+bool serverCommand(Server *server, const char *line, const char *end, char *reply){
+    Token tokens[MAX_TOKENS];
+    char pidBuffer[MAX_PID_LENGTH + 1];
+    char typeBuffer[MAX_PID_LENGTH + 1];
+    int tokenCount = tokenizeLine(line, end, tokens);
+
+    long value = 0;
+
+    if (tokenCount == 0) strcpy(reply, "ERR Invalid command.\n");
+    else if ((tokenIs(tokens[0], "rq") || tokenIs(tokens[0], "rl") || tokenIs(tokens[0], "rs")) && tokenCount >= 2 && tokens[1].length > ALLOCSIM_PID_MAX) strcpy(reply, "ERR PID is too long.\n");
+    else if (tokenIs(tokens[0], "rq") && (tokenCount == 4 || tokenCount == 5)) {
+        AllocSimLifetime lifetime = tokenCount == 5 && tokenIs(tokens[4], "long") ? ALLOCSIM_LIFETIME_LONG : ALLOCSIM_LIFETIME_SHORT;
+        if (!tokenToLong(tokens[2], &value)) strcpy(reply, "ERR Invalid memory request size.\n");
+        else if (tokenCount == 5 && lifetime == ALLOCSIM_LIFETIME_SHORT && !tokenIs(tokens[4], "short")) sprintf(reply, "ERR %s\n", allocsim_strerror(ALLOCSIM_ERR_INVALID_LIFETIME));
+        else serverRequest(server, tokenToString(tokens[1], pidBuffer), value, tokenToString(tokens[3], typeBuffer), lifetime, reply);
+    }
+    else if (tokenIs(tokens[0], "rl") && tokenCount == 2) serverRelease(server, tokenToString(tokens[1], pidBuffer), reply);
+    else if (tokenIs(tokens[0], "rs") && (tokenCount == 3 || tokenCount == 4)) {
+        if (!tokenToLong(tokens[2], &value)) strcpy(reply, "ERR Invalid memory request size.\n");
+        else serverResize(server, tokenToString(tokens[1], pidBuffer), value, tokenCount == 4 ? tokens[3].start[0] : 0, reply);
+    }
+    else if (tokenIs(tokens[0], "c") && tokenCount <= 2) {
+        if (tokenCount == 2 && !tokenToLong(tokens[1], &value)) strcpy(reply, "ERR Invalid hole size.\n");
+        else serverCompact(server, value, reply);
+    }
+    else if ((tokenIs(tokens[0], "stat") || tokenIs(tokens[0], "stats")) && tokenCount == 1) serverStat(server, reply);
+    else if ((tokenIs(tokens[0], "exit") || tokenIs(tokens[0], "x")) && tokenCount == 1) return false;
+    else strcpy(reply, "ERR Invalid command.\n");
+    return true;
+}
+
+typedef struct {
+    Server *server;
+    int fd; // connected client socket
+} Client;
+
+// serves one client until it quits or disconnects -> pipelined lines are answered in order
+void *clientWorker(void *argument){
+    Client *client = (Client *) argument;
+    char input[SERVER_LINE * 8];
+    size_t used = 0;
+    bool open = true;
+
+    while (open) {
+        ssize_t got = read(client->fd, input + used, sizeof(input) - used);
+        if (got <= 0) break;
+        used += got;
+
+        char output[sizeof(input) / 2 * 3]; // replies of every complete line of this read
+        size_t written = 0;
+        char *line = input;
+        char *newline;
+        while (open && (newline = memchr(line, '\n', input + used - line)) != NULL) {
+            char reply[SERVER_LINE];
+            open = serverCommand(client->server, line, newline, reply);
+            if (open) {
+                size_t length = strlen(reply);
+                if (written + length > sizeof(output)) { // flush before the buffer overflows
+                    if (write(client->fd, output, written) < 0) open = false;
+                    written = 0;
+                }
+                memcpy(output + written, reply, length);
+                written += length;
+            }
+            line = newline + 1;
         }
+        if (written > 0 && write(client->fd, output, written) < 0) open = false;
+
+        used -= line - input; // keep the unfinished line for the next read
+        memmove(input, line, used);
+        if (used == sizeof(input)) break; // line too long -> drop client
     }
 
-    // Lastly, update Memory head to point to new head
-    memory.head = newHead;
+    close(client->fd);
+    free(client);
+    return NULL;
 }
 
+// runs the daemon until it is killed -> false if the socket can't be set up
+bool runServer(const char *socketPath, long total_memory, int arenaCount){
+    Server server;
+    server.arenaCount = arenaCount;
+    server.arenas = (Arena *) malloc(sizeof(Arena) * arenaCount);
+    server.stripes = (DirectoryStripe *) calloc(DIRECTORY_STRIPES, sizeof(DirectoryStripe));
+    for (int i = 0; i < DIRECTORY_STRIPES; i++) pthread_mutex_init(&server.stripes[i].lock, NULL);
+
+    // equal arenas, the last one also takes the remainder
+    long arenaSize = total_memory / arenaCount;
+    for (int i = 0; i < arenaCount; i++) {
+        long size = i == arenaCount - 1 ? total_memory - arenaSize * i : arenaSize;
+        server.arenas[i].memory = createMemory(size, true); // errors go to clients, not to stderr
+        server.arenas[i].offset = arenaSize * i;
+        pthread_mutex_init(&server.arenas[i].lock, NULL);
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    unlink(socketPath); // remove socket left by an old run
+
+    server.listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server.listener < 0 || bind(server.listener, (struct sockaddr *) &address, sizeof(address)) < 0 ||
+        listen(server.listener, 128) < 0) {
+        printError(NULL, "ERROR: Could not open server socket.");
+        return false;
+    }
+    signal(SIGPIPE, SIG_IGN); // clients that disconnect early must not kill the daemon
 
-void printError(char *error){
+    printf("Serving %ld bytes in %d arenas on %s\n", total_memory, arenaCount, socketPath);
+    fflush(stdout);
 
-/* TODO*/
+    while (1) {
+        int fd = accept(server.listener, NULL, NULL);
+        if (fd < 0) continue;
 
-/*
-Prints an error message to the screen.
-*/
-    if (!scripted_mode) {
-        fprintf(stderr, "%s\n", error); // print error to standard error output stream
+        Client *client = (Client *) malloc(sizeof(Client));
+        client->server = &server;
+        client->fd = fd;
+
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, clientWorker, client) != 0) {
+            close(fd);
+            free(client);
+            continue;
+        }
+        pthread_detach(thread);
     }
 }
 
+// *************************************************************************************
+
 
 
 
+#define INPUT_SIZE 4096 // longest interactive command line -> room for RQB bursts
+
 int main(int argc, char *argv[]) {
 	/* TODO: fill the line below with your names and ids */
 	printf(" Group Name: Hole Lotta Trouble  \n Student(s) Name: Sinemis Toktaş \n Student(s) ID: 0076644\n ");
 
+    Memory *memory = NULL; // memory driven by the command line
+    long memory_amount = 0; // bytes given on the command line
     
     // initialize first hole
     if(argc == 2) {
 		/* TODO: Interactive mode */
 
-        int int_memory_amount = atoi(argv[1]);  // get initial memory amount from first argument
+        if (!parseLong(argv[1], &memory_amount) || memory_amount <= 0) { // get initial memory amount from first argument
+            printError(NULL, "ERROR: Memory size must be a positive number of bytes.");
+            return 1;
+        }
 
         // initialize memory as linked list
-        memory.total_memory = int_memory_amount;
-        memory.head = createBlock(HOLE_PID, 0, int_memory_amount); // init main memory as one GIANT hole
+        memory = createMemory(memory_amount, false); // init main memory as one GIANT hole
+        setLegacyBestFit(memory, true); // same output as the original allocator
 
-		printf("HOLE INITIALIZED AT ADDRESS %d WITH %d BYTES\n", memory.head->base, memory.head->limit);
+		printf("HOLE INITIALIZED AT ADDRESS %d WITH %ld BYTES\n", 0, memory_amount);
+
+    } else if(argc == 4 && strcmp(argv[1], "--convert") == 0) {
+        // converts a text script to a binary trace: --convert <script> <trace>
+        if (!convertScript(argv[2], argv[3])) {
+            fprintf(stderr, "ERROR: Could not convert script file.\n");
+            return 1;
+        }
+        printf("Converted %s to binary trace %s\n", argv[2], argv[3]);
+        return 0;
+
+    } else if((argc == 5 || argc == 6) && strcmp(argv[1], "--sweep") == 0) {
+        // replays a script on every strategy and memory size: --sweep <script> <strategies> <size,size,...> [threads]
+        int threads = argc == 6 ? atoi(argv[5]) : (int) sysconf(_SC_NPROCESSORS_ONLN);
+        if (threads <= 0) threads = 1;
+        return runSweep(argv[2], argv[3], argv[4], threads) ? 0 : 1;
+
+    } else if((argc == 4 || argc == 5) && strcmp(argv[1], "--serve") == 0) {
+        // daemon mode: --serve <socket> <memory> [arenas]
+        int arenas = argc == 5 ? atoi(argv[4]) : (int) sysconf(_SC_NPROCESSORS_ONLN);
+        if (arenas <= 0) arenas = 1;
+        if (!parseLong(argv[3], &memory_amount) || memory_amount < arenas) {
+            printError(NULL, "ERROR: Server memory must have at least one byte per arena.");
+            return 1;
+        }
+        return runServer(argv[2], memory_amount, arenas) ? 0 : 1;
+
+    } else if((argc == 3 || argc == 4) && strcmp(argv[1], "--snapshot") == 0) {
+        // starts from a SAVE file: --snapshot <file> [script] -> interactive mode unless a script is given
+        memory = createMemory(1, argc == 4); // replaced by the snapshot
+        setLegacyBestFit(memory, true); // kept across LOAD
+        if (!loadMemory(memory, argv[2])) {
+            printError(NULL, "ERROR: Could not load snapshot file.");
+            return 1;
+        }
+        if (argc == 4) {
+            if (!runScript(memory, argv[3])) {
+                printError(NULL, "ERROR: Could not open script file.");
+                return 1;
+            }
+            status(memory);
+            printStats(memory);
+            printProfileAtExit(memory);
+            return 0;
+        }
 
     } else if(argc == 3) {
 		/* TODO: Scripted mode*/
 
-        scripted_mode = 1; // scripted mode on -> for printError
-
-        int int_memory_amount = atoi(argv[1]);  // get initial memory amount from first argument
+        if (!parseLong(argv[1], &memory_amount) || memory_amount <= 0) { // get initial memory amount from first argument
+            printError(NULL, "ERROR: Memory size must be a positive number of bytes.");
+            return 1;
+        }
         char *fileName = argv[2]; // get file name from second argument
 
-        // initialize memory as linked list
-        memory.total_memory = int_memory_amount;
-        memory.head = createBlock(HOLE_PID, 0, int_memory_amount); // init main memory as one GIANT hole
+        // initialize memory as linked list, scripted mode on -> for printError
+        memory = createMemory(memory_amount, true); // init main memory as one GIANT hole
+        setLegacyBestFit(memory, true); // same output as the original allocator
 
-        // open file with given file name in read mode
-        // source: https://www.geeksforgeeks.org/basics-file-handling-c/
-        FILE *fptr = fopen(fileName, "r");
-
-        if (fptr == NULL){
-            printError("ERROR: Could not open script file.");
+        // map file with given file name and replay it -> text script or binary trace from --convert
+        if (!runScript(memory, fileName)){
+            printError(memory, "ERROR: Could not open script file.");
             return 1;
         } 
         else{
-            // read the file
-            char line[50]; // Declare the character array for each line to be read from file
-
-            // Read the data from the file using fgets() method
-            while (fgets(line, 50, fptr) != NULL) {
-                line[strcspn(line, "\n")] = '\0'; // remove newline from line
-
-                if(line[0] == '\0') { // empty input = do nothing 
-                    continue;
-                }
-
-                // tokenize inputs at each line like it is done in interactive mode
-                char* arguments[4]; // max is 4 for RQ
-                char* token = strtok(line, " ");
-                int tokenCount = 0;
-
-                while(token != NULL){ // get all arguments from input
-                    arguments[tokenCount] = token;
-                    token = strtok(NULL, " ");
-                    tokenCount++;
-                }
-                
-                // make commands case insensitive, i.e. should accept rq,RQ,rl,RL,stat,STAT,c,C,exit,EXIT
-                lowercase(arguments[0]);
-
-                // RQ (Request Memory / allocate): Needs 4 arguments and must check if they are valid arguments
-                if(strcmp(arguments[0], "rq") == 0){
-                    if(  tokenCount == 4  ){
-                        allocate(  arguments[1], atoi(arguments[2]), arguments[3] );
-                    }
-                }
-                // RL (Release Memory / Deallocate): Needs 2 arguments and must check if they are valid arguments
-                else if(strcmp(arguments[0], "rl") == 0){
-                    if(  tokenCount == 2  ){
-                        deallocate(  arguments[1]  );
-                    }
-                }
-                // ignore STAT 
-
-                // C (Compact): Needs 1 argument
-                else if(strcmp(arguments[0], "c") == 0){
-                    if(  tokenCount == 1  ){
-                        /* TODO*/
-                        compact();
-                    }
-                }
-                // EXIT: Needs 1 argument
-                else if(strcmp(arguments[0], "exit") == 0){
-                    if(tokenCount == 1){
-                        break;
-                    }
-                    
-                }
-                // If command is not recognized, do nothing and continue
-                else{
-                    continue;
-                }
-
-            }
-
-            // Closing the file using fclose()
-            fclose(fptr);
-
             // Final STAT output after file read ends
-            status();
+            status(memory);
+            printStats(memory); // summary of the final map
+            printProfileAtExit(memory);
 
             return 0; // prevent going to interactive mode
         }
 
 		
     } else {
-        printError("ERROR Invalid number of arguments.\n");
+        printError(memory, "ERROR Invalid number of arguments.\n");
         return 1;
     }
     
     while(1){
-        char *input = malloc(sizeof(char) * 100);
+        char input[INPUT_SIZE]; // reused by every command -> tokens point into it
         printf("allocator>");
-        fgets(input, 100, stdin);
+        if (fgets(input, INPUT_SIZE, stdin) == NULL) break; // end of input ends the session like EXIT
         input[strcspn(input, "\n")] = '\0'; // remove newline from input
 
         if(input[0] == '\0') { // empty input = do nothing 
@@ -513,71 +1277,207 @@ int main(int argc, char *argv[]) {
         }
 
 
-        char* arguments[4]; // changed from 3 to 4 with instructor's approval
+        char* arguments[INPUT_SIZE / 2]; // changed from 3 to 4 with instructor's approval, 5 for RQ lifetime hints, any number for RQB
+        long bytes, end;    // checked numeric arguments -> sizes and STAT address ranges
         char* token = strtok(input, " ");
         int tokenCount = 0;
 
         // get all arguments from input
         while(token != NULL){
-            arguments[tokenCount] = token;
+            arguments[tokenCount] = token; // tokens are separated by spaces, so a line holds at most INPUT_SIZE / 2
             token = strtok(NULL, " ");
             tokenCount++;
         }
+        if (tokenCount == 0) continue; // line of spaces only
 		
 		// TODO: make commands case insensitive, i.e. should accept rq,RQ,rl,RL,stat,STAT,c,C,exit,EXIT
         lowercase(arguments[0]);
+        PROFILE_START(started); // dispatch latency of the command
 
-        // RQ (Request Memory / allocate): Needs 4 arguments and must check if they are valid arguments
+        // RQ (Request Memory / allocate): Needs 4 arguments and must check if they are valid arguments, optional 5th is SHORT or LONG
         if(strcmp(arguments[0], "rq") == 0){
-            if(  tokenCount == 4  ){
-                allocate(  arguments[1], atoi(arguments[2]), arguments[3] );
+            if(  tokenCount == 5  ) lowercase(arguments[4]); // lifetime hint is case insensitive
+
+            if(  tokenCount == 4 && parseLong(arguments[2], &bytes)  ){
+                allocate(  memory, arguments[1], bytes, arguments[3] );
+            }
+            else if(  tokenCount == 5 && parseLong(arguments[2], &bytes) && (strcmp(arguments[4], "short") == 0 || strcmp(arguments[4], "long") == 0)  ){
+                allocateHinted(  memory, arguments[1], bytes, arguments[3], strcmp(arguments[4], "long") == 0  );
+            }
+            else if(  tokenCount == 5 && parseLong(arguments[2], &bytes)  ){
+                printError(memory, "ERROR: Invalid lifetime hint, must be SHORT or LONG.");
+            }
+            else if(  tokenCount == 4 || tokenCount == 5  ){
+                printError(memory, "ERROR: Invalid memory request size.");
             }
             else{
-                printError("ERROR Expected expression: RQ \"PID\" \"Bytes\" \"Algorithm\".");
+                printError(memory, "ERROR Expected expression: RQ \"PID\" \"Bytes\" \"Algorithm\" [SHORT|LONG].");
+            }
+        }
+        // RQB (Batch request): Needs a strategy and at least one PID:Bytes item
+        else if(strcmp(arguments[0], "rqb") == 0){
+            if(  tokenCount >= 3  ){
+                requestBatch(  memory, arguments[1], arguments + 2, tokenCount - 2  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: RQB \"Algorithm\" \"PID:Bytes\" ...");
             }
         }
         // RL (Release Memory / Deallocate): Needs 2 arguments and must check if they are valid arguments
         else if(strcmp(arguments[0], "rl") == 0){
-            if(  tokenCount == 2  ){
-                deallocate(  arguments[1]  );
+            if(  tokenCount == 2 && arguments[1][0] == '@'  ){ // RL @address releases the process starting at address
+                if (parseLong(arguments[1] + 1, &bytes)) deallocateAt(  memory, bytes  );
+                else printError(memory, "ERROR: Invalid address.");
+            }
+            else if(  tokenCount == 2  ){
+                deallocate(  memory, arguments[1]  );
             }
             else{
-                printError("ERROR Expected expression: RL \"PID\".");
+                printError(memory, "ERROR Expected expression: RL \"PID\" | RL @\"Address\".");
+            }
+        }
+        // RS (Resize): Needs 3 arguments, optional 4th argument is the algorithm used if the process has to move
+        else if(strcmp(arguments[0], "rs") == 0){
+            if(  (tokenCount == 3 || tokenCount == 4) && parseLong(arguments[2], &bytes)  ){
+                reallocate(  memory, arguments[1], bytes, tokenCount == 4 ? arguments[3] : NULL  );
+            }
+            else if(  tokenCount == 3 || tokenCount == 4  ){
+                printError(memory, "ERROR: Invalid memory request size.");
+            }
+            else{
+                printError(memory, "ERROR Expected expression: RS \"PID\" \"Bytes\" [\"Algorithm\"].");
             }
         }
         // STATUS: Needs 1 argument
         else if(strcmp(arguments[0], "stat") == 0){
+            if(  tokenCount == 2  ) lowercase(arguments[1]); // SUMMARY is case insensitive
+
+            if(  tokenCount == 1  ){
+                status(memory);
+            }
+            else if(  tokenCount == 2 && strcmp(arguments[1], "summary") == 0  ){
+                statusSummary(memory);
+            }
+            else if(  tokenCount == 3 && parseLong(arguments[1], &bytes) && parseLong(arguments[2], &end) && bytes >= 0 && bytes <= end  ){
+                statusRange(  memory, bytes, end  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: STATUS [SUMMARY | <start> <end>].");
+            }
+        }
+        // WHO: Needs 2 arguments
+        else if(strcmp(arguments[0], "who") == 0){
+            if(  tokenCount == 2 && parseLong(arguments[1], &bytes)  ){
+                whoOwns(  memory, bytes  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: WHO \"Address\".");
+            }
+        }
+        // STATS: Needs 1 argument
+        else if(strcmp(arguments[0], "stats") == 0){
             if(  tokenCount == 1  ){
-                status();
+                printStats(memory);
             }
             else{
-                printError("ERROR Expected expression: STATUS.");
+                printError(memory, "ERROR Expected expression: STATS.");
             }
         }
-        // C (Compact): Needs 1 argument
+        // C (Compact): Needs 1 argument, optional 2nd argument is the hole size to stop at
         else if(strcmp(arguments[0], "c") == 0){
             if(  tokenCount == 1  ){
                 /* TODO*/
-                compact();
+                compact(memory, 0);
 			}
+            else if(  tokenCount == 2 && parseLong(arguments[1], &bytes)  ){
+                compact(  memory, bytes  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: C [\"Bytes\"].");
+            }
+        }
+        // AUTOC (Compact on failure): Needs 2 arguments
+        else if(strcmp(arguments[0], "autoc") == 0){
+            if(  tokenCount == 2  ){
+                setCompactOnFailure(  memory, arguments[1]  );
+            }
             else{
-                printError("ERROR Expected expression: C.");
+                printError(memory, "ERROR Expected expression: AUTOC \"ON|OFF\".");
+            }
+        }
+        // SOA (Block table for first-fit): Needs 2 arguments
+        else if(strcmp(arguments[0], "soa") == 0){
+            if(  tokenCount == 2  ){
+                setBlockTableMode(  memory, arguments[1]  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: SOA \"ON|OFF\".");
+            }
+        }
+        // FAST (Quick lists with deferred merging): Needs 2 arguments
+        else if(strcmp(arguments[0], "fast") == 0){
+            if(  tokenCount == 2  ){
+                setQuickListsMode(  memory, arguments[1]  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: FAST \"ON|OFF\".");
+            }
+        }
+        // CONSOLIDATE (Merge quick lists): Needs 1 argument
+        else if(strcmp(arguments[0], "consolidate") == 0){
+            if(  tokenCount == 1  ){
+                consolidate(  memory  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: CONSOLIDATE.");
+            }
+        }
+        // SAVE (Snapshot to file): Needs 2 arguments
+        else if(strcmp(arguments[0], "save") == 0){
+            if(  tokenCount == 2  ){
+                saveMemory(  memory, arguments[1]  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: SAVE \"File\".");
+            }
+        }
+        // LOAD (Snapshot from file): Needs 2 arguments
+        else if(strcmp(arguments[0], "load") == 0){
+            if(  tokenCount == 2  ){
+                loadMemory(  memory, arguments[1]  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: LOAD \"File\".");
+            }
+        }
+        // PROF (Profile dump): optional format JSON|CSV and file
+        else if(strcmp(arguments[0], "prof") == 0){
+            if(  tokenCount <= 3  ){
+                printProfileMode(  memory, tokenCount >= 2 ? arguments[1] : NULL, tokenCount == 3 ? arguments[2] : NULL  );
+            }
+            else{
+                printError(memory, "ERROR Expected expression: PROF [JSON|CSV] [\"File\"].");
             }
         }
         // EXIT: Needs 1 argument
         else if(strcmp(arguments[0], "exit") == 0 || strcmp(arguments[0], "x") == 0){
             if(tokenCount == 1){
                 printf("Exiting program.\n");
+                printProfileAtExit(memory);
                 exit(0);
             }
             else{
-                printError("ERROR Expected expression: EXIT.");
+                printError(memory, "ERROR Expected expression: EXIT.");
             }
         }
         // If command is not recognized, print error message and continue
         else{
-            printError("ERROR Invalid command.");
+            printError(memory, "ERROR Invalid command.");
         }
+        PROFILE_COMMAND(memory, arguments[0], started);
     }
-}
 
+    printf("\n");
+    printProfileAtExit(memory);
+    return 0;
+}